@@ -0,0 +1,220 @@
+/**
+ *
+ * Name        : contention_bench.cpp
+ * Version     : v0.7.4
+ * Description : Trigger and dispatch contention against the stand-in server, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/*
+ *  Usage: contention_bench [options]
+ *
+ *    --threads N        highest number of producer threads (default hardware concurrency)
+ *    --calls C          calls per thread and thread count (default 20000)
+ *    --ops LIST         comma separated: trigger, channel, bind, subscribe (default trigger,channel)
+ *    --stress S         instead of measuring, run all operations mixed on N threads for S seconds
+ *
+ *  Drives the API from 1, 2, 4 ... N threads against a stand-in server
+ *  in the same process while the IO thread dispatches the echoed results
+ *  and channel events. For every thread count it reports throughput, the
+ *  speedup over one thread, latency percentiles of a single call and the
+ *  serialized fraction of a call estimated from the speedup (Amdahl),
+ *  which is the share of its time spent holding locks other producers
+ *  wait for. Build it with -fsanitize=thread and run --stress to check
+ *  the operations for data races; bind and subscribe change tables the IO
+ *  thread reads without a lock, so expect reports for them.
+ */
+
+#include "standin_server.hpp"
+#include <algorithm>
+#include <cstdio>
+
+enum BenchOp {
+  OP_TRIGGER,       /* WebsocketRails::trigger, answered by a result      */
+  OP_CHANNEL,       /* Channel::trigger, broadcast back to this client    */
+  OP_BIND,          /* bind and unbindAll of an event of the thread       */
+  OP_SUBSCRIBE      /* subscribe and unsubscribe a channel of the thread  */
+};
+
+static const char * op_names[] = { "trigger", "channel", "bind", "subscribe" };
+
+static boost::atomic<unsigned long> delivered(0);
+
+
+static void onDelivery(jsonxx::Object /* data */) {
+  delivered++;
+}
+
+
+static void onNothing(jsonxx::Object /* data */) {}
+
+
+static void runOp(WebsocketRails & dispatcher, Channel * channel, BenchOp op, std::size_t thread, std::size_t i) {
+  switch(op) {
+    case OP_TRIGGER:
+      dispatcher.trigger("bench.echo", jsonxx::Object("n", static_cast<jsonxx::Number>(i)));
+      break;
+    case OP_CHANNEL:
+      channel->trigger("tick", jsonxx::Object("n", static_cast<jsonxx::Number>(i)));
+      break;
+    case OP_BIND: {
+      std::string event_name = "bench.bind." + boost::lexical_cast<std::string>(thread);
+      dispatcher.bind(event_name, onNothing);
+      dispatcher.unbindAll(event_name);
+      break;
+    }
+    case OP_SUBSCRIBE: {
+      std::string channel_name = "bench.thread." + boost::lexical_cast<std::string>(thread);
+      dispatcher.subscribe(channel_name);
+      dispatcher.unsubscribe(channel_name);
+      break;
+    }
+  }
+}
+
+
+/* Time every call of one thread, in nanoseconds */
+static void producer(WebsocketRails * dispatcher, Channel * channel, BenchOp op, std::size_t thread, std::size_t calls, boost::barrier * start, std::vector<long> * samples) {
+  samples->reserve(calls);
+  start->wait();
+  for(std::size_t i = 0; i < calls; i++) {
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    runOp(*dispatcher, channel, op, thread, i);
+    samples->push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+  }
+}
+
+
+/* All operations in a random mix, for race detectors rather than numbers */
+static void stressor(WebsocketRails * dispatcher, Channel * channel, std::size_t thread, std::chrono::steady_clock::time_point until, unsigned long * calls) {
+  unsigned int seed = static_cast<unsigned int>(thread * 2654435761u);
+  while(std::chrono::steady_clock::now() < until) {
+    seed = seed * 1103515245u + 12345u;
+    runOp(*dispatcher, channel, static_cast<BenchOp>((seed >> 16) % 4), thread, *calls);
+    (*calls)++;
+  }
+}
+
+
+static double percentile(std::vector<long> & samples, double percentile) {
+  return samples[static_cast<std::size_t>(percentile / 100.0 * (samples.size() - 1))] / 1000.0;
+}
+
+
+int main(int argc, char * argv[]) {
+  std::size_t max_threads = boost::thread::hardware_concurrency();
+  std::size_t calls = 20000;
+  long stress = 0;
+  std::vector<BenchOp> ops;
+  std::string op_list = "trigger,channel";
+  for(int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if(arg == "--threads")     { max_threads = std::atol(argv[i + 1]); }
+    else if(arg == "--calls")  { calls = std::atol(argv[i + 1]); }
+    else if(arg == "--ops")    { op_list = argv[i + 1]; }
+    else if(arg == "--stress") { stress = std::atol(argv[i + 1]); }
+    else {
+      std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  for(int op = OP_TRIGGER; op <= OP_SUBSCRIBE; op++) {
+    if(("," + op_list + ",").find(std::string(",") + op_names[op] + ",") != std::string::npos) {
+      ops.push_back(static_cast<BenchOp>(op));
+    }
+  }
+  if(max_threads == 0) {
+    max_threads = 1;
+  }
+  Logger::setLevel(LOG_ERROR);
+
+  StandinServer server;
+  if(server.start(0) == 0) {
+    return 1;
+  }
+  WebsocketRails dispatcher(server.getUrl());
+  if(dispatcher.connect() != "connected") {
+    std::fprintf(stderr, "Connection failed\n");
+    return 1;
+  }
+  Channel * channel = dispatcher.subscribe("bench");
+  channel->bind("tick", onDelivery);
+  boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+
+  if(stress > 0) {
+    std::chrono::steady_clock::time_point until = std::chrono::steady_clock::now() + std::chrono::seconds(stress);
+    std::vector<unsigned long> counts(max_threads, 0);
+    boost::thread_group threads;
+    for(std::size_t t = 0; t < max_threads; t++) {
+      threads.create_thread(boost::bind(&stressor, &dispatcher, channel, t, until, &counts[t]));
+    }
+    threads.join_all();
+    unsigned long total = 0;
+    for(std::size_t t = 0; t < max_threads; t++) {
+      total += counts[t];
+    }
+    std::printf("stress: %lu calls on %zu threads in %ld s, %lu channel events delivered\n", total, max_threads, stress, static_cast<unsigned long>(delivered));
+    dispatcher.disconnect();
+    server.stop();
+    return 0;
+  }
+
+  std::printf("%-10s %7s %12s %8s %9s %9s %9s %9s %7s\n", "op", "threads", "calls/s", "speedup", "p50 us", "p99 us", "p99.9 us", "max us", "serial");
+  for(std::vector<BenchOp>::iterator op = ops.begin(); op != ops.end(); ++op) {
+    double single = 0;
+    for(std::size_t n = 1; ; n = std::min(n * 2, max_threads)) {
+      std::vector<std::vector<long> > samples(n);
+      boost::barrier start(n + 1);
+      boost::thread_group threads;
+      for(std::size_t t = 0; t < n; t++) {
+        threads.create_thread(boost::bind(&producer, &dispatcher, channel, *op, t, calls, &start, &samples[t]));
+      }
+      start.wait();
+      std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+      threads.join_all();
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+      std::vector<long> all;
+      for(std::size_t t = 0; t < n; t++) {
+        all.insert(all.end(), samples[t].begin(), samples[t].end());
+      }
+      std::sort(all.begin(), all.end());
+      double throughput = seconds > 0 ? all.size() / seconds : 0;
+      if(n == 1) {
+        single = throughput;
+      }
+      double speedup = single > 0 ? throughput / single : 0;
+      /* Amdahl: speedup = n / (1 + s (n - 1)) */
+      double serial = n > 1 && speedup > 0 ? std::min(1.0, std::max(0.0, (n / speedup - 1) / (n - 1))) : 0;
+      std::printf("%-10s %7zu %12.0f %8.2f %9.1f %9.1f %9.1f %9.1f %6.0f%%\n", op_names[*op], n, throughput, speedup,
+                  percentile(all, 50), percentile(all, 99), percentile(all, 99.9), all.back() / 1000.0, serial * 100);
+
+      /* Let the echoes of this round drain before the next one */
+      dispatcher.drain(TIMEOUT_CONN);
+      if(n == max_threads) {
+        break;
+      }
+    }
+  }
+  std::printf("%lu channel events delivered\n", static_cast<unsigned long>(delivered));
+  dispatcher.disconnect();
+  server.stop();
+  return 0;
+}
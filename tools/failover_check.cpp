@@ -0,0 +1,155 @@
+/**
+ *
+ * Name        : failover_check.cpp
+ * Version     : v0.7.4
+ * Description : Connect racing and failover against stand-in servers, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/*
+ *  Usage: failover_check [--servers N] [--stagger MS]
+ *
+ *  Races connect() over a silent endpoint (accepts TCP, never answers the
+ *  handshake), a refused port and N stand-in servers (default 3). Then it
+ *  takes down the server in use one at a time and reports how long the
+ *  loss took to notice and reconnect() took to fail over, and whether the
+ *  subscribed channel came back on the new server.
+ */
+
+#include "standin_server.hpp"
+#include <cstdio>
+
+typedef std::chrono::steady_clock::time_point time_point;
+
+static long millisSince(time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/* Wait up to timeout milliseconds for done */
+static bool waitUntil(boost::function<bool()> done, long timeout) {
+  time_point start = std::chrono::steady_clock::now();
+  while(!done() && millisSince(start) < timeout) {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(5));
+  }
+  return done();
+}
+
+
+static bool hasToken(WebsocketRails * dispatcher, std::string channel_name) {
+  Channel * channel = dispatcher->getChannel(channel_name);
+  return channel != NULL && !channel->getToken().empty();
+}
+
+
+static bool isLost(WebsocketRails * dispatcher) {
+  return !dispatcher->isConnected();
+}
+
+
+static std::string loopbackUrl(uint16_t port) {
+  return "ws://127.0.0.1:" + boost::lexical_cast<std::string>(port) + "/websocket";
+}
+
+
+int main(int argc, char * argv[]) {
+  std::size_t server_count = 3;
+  long stagger = RACE_STAGGER;
+  for(int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if(arg == "--servers")      { server_count = std::atol(argv[i + 1]); }
+    else if(arg == "--stagger") { stagger = std::atol(argv[i + 1]); }
+    else {
+      std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if(server_count == 0) {
+    server_count = 1;
+  }
+  Logger::setLevel(LOG_ERROR);
+
+  /* A listener that never accepts: the TCP handshake completes in the backlog, the websocket one never does */
+  boost::asio::io_service silent_service;
+  boost::asio::ip::tcp::acceptor silent(silent_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+  /* A port nobody listens on */
+  uint16_t refused_port;
+  {
+    boost::asio::ip::tcp::acceptor probe(silent_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    refused_port = probe.local_endpoint().port();
+  }
+
+  std::vector<boost::shared_ptr<StandinServer> > servers;
+  for(std::size_t i = 0; i < server_count; i++) {
+    boost::shared_ptr<StandinServer> server = boost::make_shared<StandinServer>();
+    if(server->start(0) == 0) {
+      return 1;
+    }
+    servers.push_back(server);
+  }
+
+  WebsocketRails dispatcher(loopbackUrl(silent.local_endpoint().port()));
+  dispatcher.addEndpoint(loopbackUrl(refused_port));
+  for(std::size_t i = 0; i < servers.size(); i++) {
+    dispatcher.addEndpoint(servers[i]->getUrl());
+  }
+  dispatcher.setRaceStagger(stagger);
+  HeartbeatPolicy policy;
+  policy.probe_interval = 100;
+  dispatcher.setHeartbeatPolicy(policy);
+
+  time_point start = std::chrono::steady_clock::now();
+  std::string state = dispatcher.connect();
+  std::printf("connect    : %s via %s in %ld ms\n", state.c_str(), dispatcher.getEndpoint().c_str(), millisSince(start));
+  if(state != "connected") {
+    return 1;
+  }
+  dispatcher.subscribe("failover");
+  bool subscribed = waitUntil(boost::bind(&hasToken, &dispatcher, "failover"), 1000);
+  std::printf("subscribe  : %s\n", subscribed ? "token received" : "no token");
+
+  int result = subscribed ? 0 : 1;
+  for(std::size_t round = 1; round < servers.size(); round++) {
+    std::string lost = dispatcher.getEndpoint();
+    for(std::size_t i = 0; i < servers.size(); i++) {
+      if(servers[i] && servers[i]->getUrl() == lost) {
+        servers[i].reset();
+      }
+    }
+    start = std::chrono::steady_clock::now();
+    bool noticed = waitUntil(boost::bind(&isLost, &dispatcher), 5000);
+    long detection = millisSince(start);
+    start = std::chrono::steady_clock::now();
+    dispatcher.reconnect();
+    long failover = millisSince(start);
+    bool restored = dispatcher.isConnected() && waitUntil(boost::bind(&hasToken, &dispatcher, "failover"), 1000);
+    std::printf("failover %lu : %s lost %s after %ld ms, %s in %ld ms, channel %s\n", static_cast<unsigned long>(round), lost.c_str(),
+                noticed ? "noticed" : "not noticed", detection, dispatcher.getEndpoint().c_str(), failover, restored ? "restored" : "missing");
+    result = restored ? result : 1;
+  }
+
+  std::printf("\n%-40s %8s %8s %10s\n", "endpoint", "connects", "failures", "rtt (us)");
+  vec_endpoint_stats stats = dispatcher.getEndpointStats();
+  for(vec_endpoint_stats::iterator it = stats.begin(); it != stats.end(); ++it) {
+    std::printf("%-40s %8lu %8lu %10ld\n", it->url.c_str(), it->connects, it->failures, it->rtt);
+  }
+  dispatcher.disconnect();
+  return result;
+}
@@ -0,0 +1,136 @@
+/**
+ *
+ * Name        : latency_bench.cpp
+ * Version     : v0.7.4
+ * Description : Trigger to ack latency against the stand-in server, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/*
+ *  Usage: latency_bench [round trips] [--low-latency] [--spin] [--cpu N] [--msgpack]
+ *
+ *  Triggers events one at a time over loopback against the stand-in
+ *  server and reports trigger to ack latency percentiles, with the default
+ *  socket setup or the low-latency profile, in JSON or MessagePack.
+ *  The cost of decoding a result frame is measured on its own first.
+ */
+
+#include "standin_server.hpp"
+#include <algorithm>
+#include <cstdio>
+
+static void printPercentile(const char * name, std::vector<long> & samples, double percentile) {
+  std::size_t index = static_cast<std::size_t>(percentile / 100.0 * (samples.size() - 1));
+  std::printf("%-6s : %ld us\n", name, samples[index]);
+}
+
+/* Decode a typical result frame over and over, with and without parsing its data */
+static void printDecodeCost(WireFormat format) {
+  const std::size_t frames = 100000;
+  std::string payload = "[[\"bench.echo\",{\"id\":\"1234567890\",\"success\":true,\"data\":{\"n\":42,\"ratio\":0.25,\"text\":\"latency bench\"}}]]";
+  if(format == WIRE_MSGPACK) {
+    std::string packed;
+    MsgpackCodec::fromJson(payload, packed);
+    payload = packed;
+  }
+  boost::shared_ptr<WireCodec> codec = WireCodec::create(format);
+  FrameArena arena(4096);
+  long elapsed[2];
+  for(int parse_data = 0; parse_data < 2; parse_data++) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < frames; i++) {
+      vec_frame_event events((ArenaAllocator<FrameEvent>(arena)));
+      codec->decode(payload, arena, events);
+      if(parse_data) {
+        events.front().getData();
+      }
+      arena.reset();
+    }
+    elapsed[parse_data] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  }
+  std::printf("decode : %ld ns/frame, %ld ns/frame with getData()\n", elapsed[0] / static_cast<long>(frames), elapsed[1] / static_cast<long>(frames));
+}
+
+
+int main(int argc, char * argv[]) {
+  std::size_t round_trips = argc > 1 ? std::atol(argv[1]) : 10000;
+  LatencyProfile profile;
+  WireFormat format = WIRE_JSON;
+  for(int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    if(arg == "--low-latency") {
+      LatencyProfile low_latency = LatencyProfile::lowLatency();
+      low_latency.cpu = profile.cpu;
+      low_latency.spin = profile.spin;
+      profile = low_latency;
+    } else if(arg == "--spin") {
+      profile.spin = true;
+    } else if(arg == "--cpu" && i + 1 < argc) {
+      profile.cpu = std::atoi(argv[++i]);
+    } else if(arg == "--msgpack") {
+      format = WIRE_MSGPACK;
+    }
+  }
+  Logger::setLevel(LOG_ERROR);
+  printDecodeCost(format);
+
+  StandinServer server;
+  if(server.start(0) == 0 || round_trips == 0) {
+    return 1;
+  }
+  WebsocketRails dispatcher(server.getUrl());
+  dispatcher.setLatencyProfile(profile);
+  dispatcher.setWireFormat(format);
+  if(dispatcher.connect() != "connected") {
+    std::fprintf(stderr, "Connection failed\n");
+    return 1;
+  }
+
+  /* Warm up the connection and the allocator before measuring */
+  for(std::size_t i = 0; i < 100; i++) {
+    dispatcher.triggerAsync("bench.echo", jsonxx::Object("n", static_cast<jsonxx::Number>(i))).waitFor(1000);
+  }
+  std::vector<long> samples;
+  samples.reserve(round_trips);
+  for(std::size_t i = 0; i < round_trips; i++) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    TriggerFuture result = dispatcher.triggerAsync("bench.echo", jsonxx::Object("n", static_cast<jsonxx::Number>(i)), 1000);
+    try {
+      result.get();
+    } catch(TriggerError & e) {
+      continue;
+    }
+    samples.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+  }
+  dispatcher.disconnect();
+  server.stop();
+  if(samples.empty()) {
+    return 1;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  std::printf("profile: nodelay=%d busy_poll=%d cpu=%d spin=%d, %zu round trips\n", profile.tcp_nodelay, profile.busy_poll, profile.cpu, profile.spin, samples.size());
+  printPercentile("p50", samples, 50);
+  printPercentile("p90", samples, 90);
+  printPercentile("p99", samples, 99);
+  printPercentile("p99.9", samples, 99.9);
+  printPercentile("max", samples, 100);
+  return 0;
+}
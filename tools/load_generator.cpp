@@ -0,0 +1,223 @@
+/**
+ *
+ * Name        : load_generator.cpp
+ * Version     : v0.7.4
+ * Description : Load generator for Websocket-Rails servers, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/*
+ *  Usage: load_generator [options]
+ *
+ *    --url URL          server to load, default a stand-in server in this process
+ *    --clients N        virtual clients (default 10)
+ *    --channels M       channels each client subscribes to (default 2)
+ *    --private P        how many of those channels are private (default 0)
+ *    --rate R           events per second per client (default 10)
+ *    --payload BYTES    payload size of each event (default 64)
+ *    --duration S       seconds to generate load (default 10)
+ *    --threads T        reactor threads (default hardware concurrency)
+ *    --format F         json or msgpack (default json)
+ *
+ *  Every client alternates between events acknowledged by the server
+ *  (ack latency) and channel events delivered to the subscribers (delivery
+ *  latency). Delivery latency uses a timestamp of the sending host, so
+ *  clients and their subscribers have to run in this process.
+ */
+
+#include "standin_server.hpp"
+#include <algorithm>
+#include <cstdio>
+
+/* Thread-safe latency samples in microseconds */
+class LatencyRecorder {
+public:
+  LatencyRecorder() : failures(0) {}
+
+  void add(long sample) {
+    boost::lock_guard<boost::mutex> guard(this->mutex);
+    this->samples.push_back(sample);
+  }
+
+  void fail() {
+    boost::lock_guard<boost::mutex> guard(this->mutex);
+    this->failures++;
+  }
+
+  std::size_t count() {
+    boost::lock_guard<boost::mutex> guard(this->mutex);
+    return this->samples.size();
+  }
+
+  void print(const char * name, double seconds) {
+    boost::lock_guard<boost::mutex> guard(this->mutex);
+    std::sort(this->samples.begin(), this->samples.end());
+    std::printf("%-10s: %8zu samples %8.1f/s %6lu failed", name, this->samples.size(), seconds > 0 ? this->samples.size() / seconds : 0.0, this->failures);
+    if(!this->samples.empty()) {
+      std::printf("  p50 %ld  p90 %ld  p99 %ld  p99.9 %ld  max %ld us", this->percentile(50), this->percentile(90), this->percentile(99), this->percentile(99.9), this->samples.back());
+    }
+    std::printf("\n");
+  }
+
+private:
+  boost::mutex mutex;
+  std::vector<long> samples;
+  unsigned long failures;
+
+  long percentile(double percentile) {
+    return this->samples[static_cast<std::size_t>(percentile / 100.0 * (this->samples.size() - 1))];
+  }
+};
+
+
+static LatencyRecorder connect_latency;
+static LatencyRecorder ack_latency;
+static LatencyRecorder delivery_latency;
+
+
+static long nowMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+static void onAck(long sent, jsonxx::Object /* data */) {
+  ack_latency.add(nowMicroseconds() - sent);
+}
+
+
+static void onNack(jsonxx::Object /* data */) {
+  ack_latency.fail();
+}
+
+
+static void onDelivery(jsonxx::Object data) {
+  if(data.has<jsonxx::Number>("ts")) {
+    delivery_latency.add(nowMicroseconds() - static_cast<long>(data.get<jsonxx::Number>("ts")));
+  }
+}
+
+
+static std::string channelName(std::size_t channel, std::size_t privates) {
+  return (channel < privates ? "load.private." : "load.public.") + boost::lexical_cast<std::string>(channel);
+}
+
+
+int main(int argc, char * argv[]) {
+  std::string url;
+  std::size_t clients = 10, channels = 2, privates = 0, payload_size = 64;
+  std::size_t threads = boost::thread::hardware_concurrency();
+  double rate = 10, duration = 10;
+  WireFormat format = WIRE_JSON;
+  for(int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if(arg == "--url")           { url = argv[i + 1]; }
+    else if(arg == "--clients")  { clients = std::atol(argv[i + 1]); }
+    else if(arg == "--channels") { channels = std::atol(argv[i + 1]); }
+    else if(arg == "--private")  { privates = std::atol(argv[i + 1]); }
+    else if(arg == "--rate")     { rate = std::atof(argv[i + 1]); }
+    else if(arg == "--payload")  { payload_size = std::atol(argv[i + 1]); }
+    else if(arg == "--duration") { duration = std::atof(argv[i + 1]); }
+    else if(arg == "--threads")  { threads = std::atol(argv[i + 1]); }
+    else if(arg == "--format")   { format = std::string(argv[i + 1]) == "msgpack" ? WIRE_MSGPACK : WIRE_JSON; }
+    else {
+      std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  Logger::setLevel(LOG_ERROR);
+
+  boost::scoped_ptr<StandinServer> server;
+  if(url.empty()) {
+    server.reset(new StandinServer());
+    if(server->start(0) == 0) {
+      return 1;
+    }
+    url = server->getUrl();
+  }
+  Reactor reactor(threads > 0 ? threads : 1);
+
+  /* Connect and subscribe the virtual clients */
+  std::vector<WebsocketRails *> dispatchers;
+  for(std::size_t i = 0; i < clients; i++) {
+    WebsocketRails * dispatcher = new WebsocketRails(url, reactor);
+    dispatcher->setWireFormat(format);
+    long start = nowMicroseconds();
+    if(dispatcher->connect() != "connected") {
+      connect_latency.fail();
+      delete dispatcher;
+      continue;
+    }
+    connect_latency.add(nowMicroseconds() - start);
+    for(std::size_t j = 0; j < channels; j++) {
+      Channel * channel = j < privates ? dispatcher->subscribePrivate(channelName(j, privates)) : dispatcher->subscribe(channelName(j, privates));
+      channel->bind("load.tick", boost::bind(onDelivery, _1));
+    }
+    dispatchers.push_back(dispatcher);
+  }
+  if(dispatchers.empty()) {
+    std::fprintf(stderr, "No client connected to %s\n", url.c_str());
+    return 1;
+  }
+
+  /* Generate load, one event every 1/(rate * clients) seconds round robin over the clients */
+  std::string payload(payload_size, 'x');
+  long interval = rate > 0 ? static_cast<long>(1e6 / (rate * dispatchers.size())) : 0;
+  long start = nowMicroseconds();
+  long end = start + static_cast<long>(duration * 1e6);
+  long next = start;
+  std::size_t sent = 0;
+  while(rate > 0 && nowMicroseconds() < end) {
+    WebsocketRails * dispatcher = dispatchers[sent % dispatchers.size()];
+    jsonxx::Object data;
+    long ts = nowMicroseconds();
+    data << "ts" << static_cast<jsonxx::Number>(ts) << "payload" << payload;
+    if(sent % 2 == 0 || channels == 0) {
+      dispatcher->trigger("load.event", data, boost::bind(onAck, ts, _1), boost::bind(onNack, _1));
+    } else {
+      dispatcher->getChannel(channelName((sent / 2) % channels, privates))->trigger("load.tick", data);
+    }
+    sent++;
+    next += interval;
+    long wait = next - nowMicroseconds();
+    if(wait > 0) {
+      boost::this_thread::sleep(boost::posix_time::microseconds(wait));
+    }
+  }
+  double elapsed = (nowMicroseconds() - start) / 1e6;
+  /* Let the last results and deliveries arrive */
+  boost::this_thread::sleep(boost::posix_time::seconds(1));
+
+  std::printf("url       : %s\n", url.c_str());
+  std::printf("clients   : %zu connected of %zu, %zu channels each (%zu private), %zu reactor threads\n", dispatchers.size(), clients, channels, std::min(privates, channels), reactor.getThreads());
+  std::printf("load      : %zu events in %.2f s, %.1f/s, %zu byte payload\n", sent, elapsed, elapsed > 0 ? sent / elapsed : 0.0, payload_size);
+  connect_latency.print("connect", 0);
+  ack_latency.print("ack", elapsed);
+  delivery_latency.print("delivery", elapsed);
+
+  for(std::size_t i = 0; i < dispatchers.size(); i++) {
+    dispatchers[i]->disconnect();
+    delete dispatchers[i];
+  }
+  reactor.stop();
+  if(server) {
+    server->stop();
+  }
+  return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ *
+ * Name        : reactor_bench.cpp
+ * Version     : v0.7.4
+ * Description : Memory and threads per connection with a shared Reactor, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/*
+ *  Usage: reactor_bench [connections] [reactor threads] [--threaded]
+ *
+ *  Opens the connections against a stand-in server in the same process
+ *  and reports resident memory and threads per connection, once on a
+ *  shared Reactor and, with --threaded, with a thread per dispatcher.
+ *  Every connection needs two file descriptors here, raise ulimit -n.
+ */
+
+#include "standin_server.hpp"
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+
+/* Read a field of /proc/self/status, e.g. VmRSS (kB) or Threads */
+static long procStatus(const std::string & field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while(std::getline(status, line)) {
+    if(line.compare(0, field.size() + 1, field + ":") == 0) {
+      return std::atol(line.c_str() + field.size() + 1);
+    }
+  }
+  return 0;
+}
+
+
+int main(int argc, char * argv[]) {
+  std::size_t connections = argc > 1 ? std::atol(argv[1]) : 1000;
+  std::size_t threads = argc > 2 ? std::atol(argv[2]) : boost::thread::hardware_concurrency();
+  bool threaded = argc > 3 && std::string(argv[3]) == "--threaded";
+  Logger::setLevel(LOG_ERROR);
+
+  StandinServer server;
+  if(server.start(0) == 0) {
+    return 1;
+  }
+  long rss_before = procStatus("VmRSS");
+  long threads_before = procStatus("Threads");
+
+  boost::scoped_ptr<Reactor> reactor(threaded ? NULL : new Reactor(threads));
+  std::vector<WebsocketRails *> dispatchers;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(std::size_t i = 0; i < connections; i++) {
+    WebsocketRails * dispatcher = threaded ? new WebsocketRails(server.getUrl()) : new WebsocketRails(server.getUrl(), *reactor);
+    dispatchers.push_back(dispatcher);
+    if(dispatcher->connect() != "connected") {
+      std::cerr << "Connection " << i << " failed" << std::endl;
+      break;
+    }
+  }
+  double connect_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  /* One round trip on every connection */
+  start = std::chrono::steady_clock::now();
+  std::vector<TriggerFuture> results;
+  for(std::size_t i = 0; i < dispatchers.size(); i++) {
+    results.push_back(dispatchers[i]->triggerAsync("bench.echo", jsonxx::Object("n", static_cast<jsonxx::Number>(i)), 10000));
+  }
+  std::size_t answered = 0;
+  for(std::size_t i = 0; i < results.size(); i++) {
+    try {
+      results[i].get();
+      answered++;
+    } catch(TriggerError & e) {
+    }
+  }
+  double trigger_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  long rss_after = procStatus("VmRSS");
+  long threads_after = procStatus("Threads");
+  std::size_t count = dispatchers.size();
+  std::printf("mode            : %s\n", threaded ? "thread per dispatcher" : "shared reactor");
+  std::printf("connections     : %zu (%zu answered)\n", count, answered);
+  std::printf("reactor threads : %zu\n", threaded ? 0 : threads);
+  std::printf("threads         : %ld total, %.3f per connection\n", threads_after - threads_before, count ? double(threads_after - threads_before) / count : 0.0);
+  std::printf("memory          : %ld kB total, %.1f kB per connection (client and server side)\n", rss_after - rss_before, count ? double(rss_after - rss_before) / count : 0.0);
+  std::printf("connect         : %.3f s, %.1f us per connection\n", connect_time, count ? connect_time * 1e6 / count : 0.0);
+  std::printf("round trip      : %.3f s for all connections\n", trigger_time);
+
+  for(std::size_t i = 0; i < dispatchers.size(); i++) {
+    dispatchers[i]->disconnect();
+    delete dispatchers[i];
+  }
+  if(reactor) {
+    reactor->stop();
+  }
+  server.stop();
+  return 0;
+}
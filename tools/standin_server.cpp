@@ -0,0 +1,237 @@
+/**
+ *
+ * Name        : standin_server.cpp
+ * Version     : v0.7.4
+ * Description : Websocket-Rails Stand-in Server Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "standin_server.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+StandinServer::StandinServer() : port(0), ping_interval(0), connection_count(0), events(0), frame_arena(FRAME_ARENA_BLOCK) {
+  this->ws_server.clear_access_channels(websocketpp::log::alevel::all);
+  this->ws_server.clear_error_channels(websocketpp::log::elevel::all);
+  this->ws_server.init_asio();
+  this->ws_server.set_reuse_addr(true);
+
+  using websocketpp::lib::placeholders::_1;
+  using websocketpp::lib::placeholders::_2;
+  using websocketpp::lib::bind;
+  this->ws_server.set_validate_handler(bind(&StandinServer::validateHandler,this,::_1));
+  this->ws_server.set_open_handler(bind(&StandinServer::openHandler,this,::_1));
+  this->ws_server.set_close_handler(bind(&StandinServer::closeHandler,this,::_1));
+  this->ws_server.set_message_handler(bind(&StandinServer::messageHandler,this,::_1,::_2));
+}
+
+
+StandinServer::~StandinServer() {
+  this->stop();
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Listen on the loopback interface, port 0 picks a free port; returns the port or 0 on error */
+uint16_t StandinServer::start(uint16_t port) {
+  websocketpp::lib::error_code ec;
+  this->ws_server.listen(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port), ec);
+  if(ec) {
+    WSR_LOG(LOG_ERROR, "Stand-in server listen error: " + ec.message());
+    return 0;
+  }
+  boost::system::error_code local_ec;
+  this->port = this->ws_server.get_local_endpoint(local_ec).port();
+  this->ws_server.start_accept();
+  if(this->ping_interval > 0) {
+    this->ws_server.set_timer(this->ping_interval, websocketpp::lib::bind(&StandinServer::pingHandler,this,websocketpp::lib::placeholders::_1));
+  }
+  this->server_thread = boost::thread(&server::run, &this->ws_server);
+  return this->port;
+}
+
+
+void StandinServer::stop() {
+  if(!this->server_thread.joinable()) {
+    return;
+  }
+  this->ws_server.stop();
+  this->server_thread.join();
+}
+
+
+std::string StandinServer::getUrl() {
+  return "ws://127.0.0.1:" + boost::lexical_cast<std::string>(this->port) + "/websocket";
+}
+
+
+/* Send websocket_rails.ping to all clients every interval, 0 for no pings; set before start() */
+void StandinServer::setPingInterval(long milliseconds) {
+  this->ping_interval = milliseconds;
+}
+
+
+/* Events received from clients, pongs excluded */
+unsigned long StandinServer::getEvents() {
+  return this->events;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Agree on MessagePack if the client asks for it, everyone else speaks JSON */
+bool StandinServer::validateHandler(websocketpp::connection_hdl hdl) {
+  websocketpp::lib::error_code ec;
+  server::connection_ptr con = this->ws_server.get_con_from_hdl(hdl, ec);
+  if(ec) {
+    return false;
+  }
+  const std::vector<std::string> & requested = con->get_requested_subprotocols();
+  if(std::find(requested.begin(), requested.end(), MsgpackCodec::subprotocol) != requested.end()) {
+    con->select_subprotocol(MsgpackCodec::subprotocol, ec);
+  }
+  return true;
+}
+
+
+void StandinServer::openHandler(websocketpp::connection_hdl hdl) {
+  std::string connection_id = "c" + boost::lexical_cast<std::string>(++this->connection_count);
+  this->connections[hdl] = connection_id;
+  websocketpp::lib::error_code ec;
+  server::connection_ptr con = this->ws_server.get_con_from_hdl(hdl, ec);
+  if(!ec && con->get_subprotocol() == MsgpackCodec::subprotocol) {
+    this->msgpack_clients.insert(hdl);
+  }
+  this->reply(hdl, frame("client_connected", "\"id\":null,\"channel\":null,\"data\":{\"connection_id\":" + quote(connection_id) + "},\"success\":null,\"result\":null"));
+}
+
+
+void StandinServer::closeHandler(websocketpp::connection_hdl hdl) {
+  this->connections.erase(hdl);
+  this->msgpack_clients.erase(hdl);
+  for(std::map<std::string, hdl_set>::iterator it = this->subscribers.begin(); it != this->subscribers.end(); ++it) {
+    it->second.erase(hdl);
+  }
+}
+
+
+void StandinServer::messageHandler(websocketpp::connection_hdl hdl, message_ptr msg) {
+  /* Clients send a single event, wrap it to parse it as a frame; MessagePack is read as its JSON form */
+  std::string payload = "[";
+  if(msg->get_opcode() == websocketpp::frame::opcode::binary) {
+    if(!MsgpackCodec::toJson(msg->get_payload(), payload)) {
+      return;
+    }
+  } else {
+    payload += msg->get_payload();
+  }
+  payload += "]";
+  this->frame_arena.reset();
+  vec_frame_event frame_events((ArenaAllocator<FrameEvent>(this->frame_arena)));
+  if(!FrameParser::parse(payload, this->frame_arena, frame_events)) {
+    return;
+  }
+  for(vec_frame_event::iterator it = frame_events.begin(); it != frame_events.end(); ++it) {
+    std::string name = it->getName().str();
+    if(name == "websocket_rails.pong") {
+      continue;
+    }
+    this->events++;
+    std::string id = quote(it->getId().str());
+    std::string data = it->getRawData().empty() ? "{}" : it->getRawData().str();
+    StringRef value, channel;
+    if(FrameParser::findMember(it->getRawData(), "channel", value)) {
+      FrameParser::readString(value, this->frame_arena, channel);
+    }
+    if(name == "websocket_rails.subscribe" || name == "websocket_rails.subscribe_private") {
+      this->subscribers[channel.str()].insert(hdl);
+      this->reply(hdl, frame(name, "\"id\":" + id + ",\"channel\":null,\"data\":{},\"success\":true,\"result\":true"));
+      this->reply(hdl, frame("websocket_rails.channel_token", "\"channel\":" + quote(channel.str()) + ",\"data\":{\"token\":" + quote("t-" + channel.str()) + "}"));
+    } else if(name == "websocket_rails.unsubscribe") {
+      this->subscribers[channel.str()].erase(hdl);
+      this->reply(hdl, frame(name, "\"id\":" + id + ",\"channel\":null,\"data\":{},\"success\":true,\"result\":true"));
+    } else if(!it->getChannel().empty()) {
+      std::string broadcast = frame(name, "\"channel\":" + quote(it->getChannel().str()) + ",\"data\":" + data);
+      hdl_set & channel_subscribers = this->subscribers[it->getChannel().str()];
+      for(hdl_set::iterator sub = channel_subscribers.begin(); sub != channel_subscribers.end(); ++sub) {
+        this->reply(*sub, broadcast);
+      }
+    } else {
+      this->reply(hdl, frame(name, "\"id\":" + id + ",\"channel\":null,\"data\":" + data + ",\"success\":true,\"result\":true"));
+    }
+  }
+  this->frame_arena.reset();
+}
+
+
+void StandinServer::pingHandler(websocketpp::lib::error_code const & ec) {
+  if(ec) {
+    return;
+  }
+  std::string ping = frame("websocket_rails.ping", "\"id\":null,\"channel\":null,\"data\":{},\"success\":null,\"result\":null");
+  for(map_hdl_id::iterator it = this->connections.begin(); it != this->connections.end(); ++it) {
+    this->reply(it->first, ping);
+  }
+  this->ws_server.set_timer(this->ping_interval, websocketpp::lib::bind(&StandinServer::pingHandler,this,websocketpp::lib::placeholders::_1));
+}
+
+
+/* Frames are built as JSON, MessagePack clients get them transcoded */
+void StandinServer::reply(websocketpp::connection_hdl hdl, const std::string & frame) {
+  websocketpp::lib::error_code ec;
+  if(this->msgpack_clients.count(hdl) == 0) {
+    this->ws_server.send(hdl, frame, websocketpp::frame::opcode::text, ec);
+    return;
+  }
+  std::string payload;
+  if(MsgpackCodec::fromJson(frame, payload)) {
+    this->ws_server.send(hdl, payload, websocketpp::frame::opcode::binary, ec);
+  }
+}
+
+
+std::string StandinServer::frame(const std::string & name, const std::string & attributes) {
+  return "[[" + quote(name) + ",{" + attributes + "}]]";
+}
+
+
+std::string StandinServer::quote(const std::string & str) {
+  std::string quoted = "\"";
+  for(std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
+    if(*it == '"' || *it == '\\') {
+      quoted += '\\';
+    }
+    quoted += *it;
+  }
+  return quoted + "\"";
+}
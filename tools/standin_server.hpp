@@ -0,0 +1,104 @@
+/**
+ *
+ * Name        : standin_server.hpp
+ * Version     : v0.7.4
+ * Description : Websocket-Rails Stand-in Server Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef STANDIN_SERVER_HPP_
+#define STANDIN_SERVER_HPP_
+
+#include "../websocket-rails-client/websocket_rails.hpp"
+#include "../websocket-rails-client/frame_parser.hpp"
+#include "../websocket-rails-client/msgpack_codec.hpp"
+#include "../websocket-rails-client/logger.hpp"
+#include <websocketpp/config/asio_no_tls.hpp>
+#include <websocketpp/server.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <set>
+#include <algorithm>
+
+/**
+ *  A minimal local stand-in for a Websocket-Rails server, for benchmarks
+ *  and offline runs. It greets with client_connected, acknowledges
+ *  subscriptions with a channel token, answers every event with a
+ *  successful result echoing its data, and broadcasts channel events to
+ *  the subscribers of the channel. Clients asking for the MessagePack
+ *  subprotocol are spoken to in binary frames. Runs on a thread of its own.
+ **/
+class StandinServer {
+public:
+
+  /**
+   *  Type Definitions
+   **/
+  typedef websocketpp::server<websocketpp::config::asio> server;
+  typedef websocketpp::config::asio::message_type::ptr message_ptr;
+  typedef std::set<websocketpp::connection_hdl, std::owner_less<websocketpp::connection_hdl> > hdl_set;
+  typedef std::map<websocketpp::connection_hdl, std::string, std::owner_less<websocketpp::connection_hdl> > map_hdl_id;
+
+  /**
+   *  Constructors
+   **/
+  StandinServer();
+  ~StandinServer();
+
+  /**
+   *  Functions
+   **/
+  uint16_t start(uint16_t port);
+  void stop();
+  std::string getUrl();
+  void setPingInterval(long milliseconds);
+  unsigned long getEvents();
+
+private:
+
+  /**
+   *  Variables
+   **/
+  server ws_server;
+  boost::thread server_thread;
+  uint16_t port;
+  long ping_interval;
+  unsigned long connection_count;
+  boost::atomic<unsigned long> events;
+  FrameArena frame_arena;
+  map_hdl_id connections;                          /* Map<key,value>: Handle, Connection Id */
+  hdl_set msgpack_clients;                         /* Connections that negotiated MessagePack */
+  std::map<std::string, hdl_set> subscribers;      /* Map<key,value>: Channel, Handles      */
+
+  /**
+   *  Functions
+   **/
+  bool validateHandler(websocketpp::connection_hdl hdl);
+  void openHandler(websocketpp::connection_hdl hdl);
+  void closeHandler(websocketpp::connection_hdl hdl);
+  void messageHandler(websocketpp::connection_hdl hdl, message_ptr msg);
+  void pingHandler(websocketpp::lib::error_code const & ec);
+  void reply(websocketpp::connection_hdl hdl, const std::string & frame);
+  static std::string frame(const std::string & name, const std::string & attributes);
+  static std::string quote(const std::string & str);
+
+};
+
+
+#endif /* STANDIN_SERVER_HPP_ */
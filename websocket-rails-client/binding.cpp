@@ -0,0 +1,107 @@
+/**
+ *
+ * Name        : binding.cpp
+ * Version     : v0.7.4
+ * Description : Binding Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+
+
+
+#include "binding.hpp"
+
+boost::atomic<std::size_t> Binding::next_id(1);
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+BindingCounters::BindingCounters() {
+  this->clear();
+  this->enrolled = false;
+}
+
+
+Binding::Binding(cb_func callback, std::string label) : callback(std::move(callback)), id(next_id++), label(label), counters(boost::make_shared<BindingCounters>()) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+void BindingCounters::clear() {
+  this->calls = 0;
+  this->total = 0;
+  this->max = 0;
+  this->slow = 0;
+  for(std::size_t i = 0; i < CALLBACK_HISTOGRAM_BUCKETS; i++) {
+    this->histogram[i] = 0;
+  }
+}
+
+
+/* Fold the counters of a binding that is gone into these */
+void BindingCounters::add(const BindingCounters & other) {
+  this->calls += other.calls;
+  this->total += other.total;
+  long max = other.max;
+  long current = this->max;
+  while(max > current && !this->max.compare_exchange_weak(current, max)) {}
+  this->slow += other.slow;
+  for(std::size_t i = 0; i < CALLBACK_HISTOGRAM_BUCKETS; i++) {
+    this->histogram[i] += other.histogram[i];
+  }
+}
+
+
+void Binding::operator()(jsonxx::Object data) const {
+  this->callback(std::move(data));
+}
+
+
+std::size_t Binding::getId() const {
+  return this->id;
+}
+
+
+/* The label, or #id for a binding without */
+std::string Binding::getName() const {
+  return this->label.empty() ? "#" + boost::lexical_cast<std::string>(this->id) : this->label;
+}
+
+
+bool Binding::isLabeled() const {
+  return !this->label.empty();
+}
+
+
+/* The counters of the binding, resolved once at bind time */
+BindingCounters & Binding::getCounters() const {
+  return *this->counters;
+}
+
+
+boost::shared_ptr<BindingCounters> Binding::shareCounters() const {
+  return this->counters;
+}
@@ -0,0 +1,92 @@
+/**
+ *
+ * Name        : binding.hpp
+ * Version     : v0.7.4
+ * Description : Binding Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+
+#ifndef BINDING_HPP_
+#define BINDING_HPP_
+
+#include "websocket.hpp"
+#include "callback.hpp"
+
+/**
+ *  Profiling counters of one binding, in microseconds. They are updated
+ *  without a lock; the profiler adds them to its sums once the binding
+ *  is gone.
+ **/
+struct BindingCounters {
+  BindingCounters();
+  void clear();
+  void add(const BindingCounters & other);
+  boost::atomic<unsigned long> calls;
+  boost::atomic<long> total;
+  boost::atomic<long> max;
+  boost::atomic<unsigned long> slow;
+  boost::atomic<unsigned long> histogram[CALLBACK_HISTOGRAM_BUCKETS];
+  boost::atomic<bool> enrolled;          /* Known to the profiler */
+};
+
+/**
+ *  A callback as bound to an event name. The id is given at bind time and
+ *  does not change when other callbacks are bound, unbound or filtered
+ *  out; the profiler reports a binding under its label, or #id without.
+ **/
+class Binding {
+public:
+
+  /**
+   *  Constructors
+   **/
+  Binding(cb_func callback, std::string label);
+
+  /**
+   *  Functions
+   **/
+  void operator()(jsonxx::Object data) const;
+  std::size_t getId() const;
+  std::string getName() const;
+  bool isLabeled() const;
+  BindingCounters & getCounters() const;
+  boost::shared_ptr<BindingCounters> shareCounters() const;
+
+private:
+
+  /**
+   *  Variables
+   **/
+  cb_func callback;
+  std::size_t id;
+  std::string label;
+  boost::shared_ptr<BindingCounters> counters;
+  static boost::atomic<std::size_t> next_id;
+
+};
+
+/* A binding is created once and shared by the tables, snapshots and queues holding it */
+typedef boost::shared_ptr<const Binding> cb_ptr;
+typedef std::vector<cb_ptr> vec_cb_func;
+typedef std::tr1::unordered_map<std::string, vec_cb_func> map_vec_cb_func;
+
+
+#endif /* BINDING_HPP_ */
@@ -0,0 +1,106 @@
+/**
+ *
+ * Name        : callback.cpp
+ * Version     : v0.7.4
+ * Description : Callback Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+
+#include "callback.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+Callback::Callback() : manager(NULL) {}
+
+
+Callback::Callback(Callback && other) : manager(other.manager) {
+  if(this->manager != NULL) {
+    this->manager->move(this->storage, other.storage);
+    other.manager = NULL;
+  }
+}
+
+
+Callback::~Callback() {
+  this->reset();
+}
+
+
+Callback & Callback::operator=(Callback && other) {
+  if(this != &other) {
+    this->reset();
+    if(other.manager != NULL) {
+      other.manager->move(this->storage, other.storage);
+      this->manager = other.manager;
+      other.manager = NULL;
+    }
+  }
+  return *this;
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Throws boost::bad_function_call if empty, as boost::function does */
+void Callback::operator()(jsonxx::Object data) const {
+  if(this->manager == NULL) {
+    boost::throw_exception(boost::bad_function_call());
+  }
+  this->manager->invoke(this->storage, data);
+}
+
+
+Callback::operator bool() const {
+  return this->manager != NULL;
+}
+
+
+bool Callback::empty() const {
+  return this->manager == NULL;
+}
+
+
+/* True if the target lives in the callback itself rather than on the heap */
+bool Callback::isInline() const {
+  return this->manager != NULL && this->manager->local;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+void Callback::reset() {
+  if(this->manager != NULL) {
+    this->manager->destroy(this->storage);
+    this->manager = NULL;
+  }
+}
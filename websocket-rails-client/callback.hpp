@@ -0,0 +1,172 @@
+/**
+ *
+ * Name        : callback.hpp
+ * Version     : v0.7.4
+ * Description : Callback Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef CALLBACK_HPP_
+#define CALLBACK_HPP_
+
+#include "websocket.hpp"
+#include <new>
+#include <type_traits>
+#include <utility>
+
+class Callback;
+
+/* True if a target of type F can be called with a jsonxx::Object and is no Callback itself */
+template<class F, class = void>
+struct isCallbackTarget : std::false_type {};
+
+template<class F>
+struct isCallbackTarget<F, decltype(void(std::declval<F &>()(std::declval<jsonxx::Object &>())))>
+  : std::integral_constant<bool, !std::is_same<F, Callback>::value> {};
+
+/**
+ *  Move-only void(jsonxx::Object) callable. Targets of up to
+ *  CALLBACK_INLINE_SIZE bytes that move without throwing, such as
+ *  boost::bind of a member function and a few arguments or a small
+ *  lambda, are stored inline; larger ones go to the heap. Any callable
+ *  taking a jsonxx::Object converts implicitly, so boost::bind expressions
+ *  and boost::function objects can be passed where a Callback is expected;
+ *  other types do not convert at all.
+ **/
+class Callback {
+public:
+
+  /**
+   *  Constructors
+   **/
+  Callback();
+  Callback(Callback && other);
+  template<class F, class = typename std::enable_if<isCallbackTarget<typename std::decay<F>::type>::value>::type>
+  Callback(F && target);
+  ~Callback();
+  Callback & operator=(Callback && other);
+  Callback(const Callback &) = delete;
+  Callback & operator=(const Callback &) = delete;
+
+  /**
+   *  Functions
+   **/
+  void operator()(jsonxx::Object data) const;
+  explicit operator bool() const;
+  bool empty() const;
+  bool isInline() const;
+
+private:
+
+  union Storage {
+    void * heap;
+    typename std::aligned_storage<CALLBACK_INLINE_SIZE, alignof(void *)>::type buffer;
+  };
+
+  /* Operations on the stored target, one table per target type and storage */
+  struct Manager {
+    void (*invoke)(Storage & storage, jsonxx::Object & data);
+    void (*move)(Storage & to, Storage & from);
+    void (*destroy)(Storage & storage);
+    bool local;
+  };
+
+  template<class F>
+  struct Inline {
+    static F * get(Storage & storage) { return reinterpret_cast<F *>(&storage.buffer); }
+    static void invoke(Storage & storage, jsonxx::Object & data) { (*get(storage))(data); }
+    static void move(Storage & to, Storage & from) { new(&to.buffer) F(std::move(*get(from))); get(from)->~F(); }
+    static void destroy(Storage & storage) { get(storage)->~F(); }
+    static const Manager manager;
+  };
+
+  template<class F>
+  struct Heap {
+    static F * get(Storage & storage) { return static_cast<F *>(storage.heap); }
+    static void invoke(Storage & storage, jsonxx::Object & data) { (*get(storage))(data); }
+    static void move(Storage & to, Storage & from) { to.heap = from.heap; }
+    static void destroy(Storage & storage) { delete get(storage); }
+    static const Manager manager;
+  };
+
+  template<class F>
+  struct fitsInline {
+    static const bool value = sizeof(F) <= CALLBACK_INLINE_SIZE && alignof(void *) % alignof(F) == 0 && std::is_nothrow_move_constructible<F>::value;
+  };
+
+  /**
+   *  Variables
+   **/
+  mutable Storage storage;      /* Called through a const Callback like boost::function, the target itself is not const */
+  const Manager * manager;      /* NULL if empty */
+
+  /**
+   *  Functions
+   **/
+  template<class F>
+  void assign(F && target, std::true_type);
+  template<class F>
+  void assign(F && target, std::false_type);
+  void reset();
+  template<class F>
+  static bool isNull(const F &) { return false; }
+  template<class Signature>
+  static bool isNull(const boost::function<Signature> & target) { return target.empty(); }
+  template<class R, class A>
+  static bool isNull(R (* target)(A)) { return target == NULL; }
+
+};
+
+typedef Callback cb_func;
+
+
+template<class F, class>
+Callback::Callback(F && target) : manager(NULL) {
+  typedef typename std::decay<F>::type target_type;
+  if(!Callback::isNull(target)) {
+    this->assign(std::forward<F>(target), std::integral_constant<bool, fitsInline<target_type>::value>());
+  }
+}
+
+
+template<class F>
+void Callback::assign(F && target, std::true_type) {
+  typedef typename std::decay<F>::type target_type;
+  new(&this->storage.buffer) target_type(std::forward<F>(target));
+  this->manager = &Inline<target_type>::manager;
+}
+
+
+template<class F>
+void Callback::assign(F && target, std::false_type) {
+  typedef typename std::decay<F>::type target_type;
+  this->storage.heap = new target_type(std::forward<F>(target));
+  this->manager = &Heap<target_type>::manager;
+}
+
+
+template<class F>
+const Callback::Manager Callback::Inline<F>::manager = { &Callback::Inline<F>::invoke, &Callback::Inline<F>::move, &Callback::Inline<F>::destroy, true };
+
+template<class F>
+const Callback::Manager Callback::Heap<F>::manager = { &Callback::Heap<F>::invoke, &Callback::Heap<F>::move, &Callback::Heap<F>::destroy, false };
+
+
+#endif /* CALLBACK_HPP_ */
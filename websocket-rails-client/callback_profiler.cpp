@@ -0,0 +1,229 @@
+/**
+ *
+ * Name        : callback_profiler.cpp
+ * Version     : v0.7.4
+ * Description : CallbackProfiler Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "callback_profiler.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+CallbackProfiler::CallbackProfiler() : budget(0), enrolls(0), prune_at(PROFILER_PRUNE_MIN) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Calls taking longer than the budget count as slow and go to the slow hook, 0 for no budget */
+void CallbackProfiler::setBudget(long micros) {
+  this->budget = micros;
+}
+
+
+long CallbackProfiler::getBudget() {
+  return this->budget;
+}
+
+
+/* Called with scope, event name, binding and microseconds after a slow call, on the dispatching thread */
+void CallbackProfiler::onSlow(slow_cb_func callback) {
+  boost::lock_guard<boost::mutex> guard(this->profiler_mutex);
+  this->on_slow = callback;
+}
+
+
+/* Run the callbacks of an event one by one and time each */
+void CallbackProfiler::dispatch(const std::string & scope, const std::string & event_name, const vec_cb_func & callbacks, const jsonxx::Object & event_data) {
+  for(vec_cb_func::const_iterator it = callbacks.begin(); it != callbacks.end(); ++it) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    (**it)(event_data);
+    long micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    this->record(scope, event_name, **it, micros);
+  }
+}
+
+
+/* Record a call by name, for callbacks that are no binding */
+void CallbackProfiler::record(const std::string & scope, const std::string & event_name, const std::string & binding, long micros) {
+  BindingCounters * counters;
+  {
+    /* An entry without retire_to is never dropped, its counters stay put */
+    boost::lock_guard<boost::mutex> guard(this->profiler_mutex);
+    counters = &this->entries[scope + ";" + event_name + ";" + binding].retired;
+  }
+  if(this->count(*counters, micros)) {
+    this->reportSlow(scope, event_name, binding, micros);
+  }
+}
+
+
+/* Record a call of a binding on its own counters, the lock is only taken on its first call */
+void CallbackProfiler::record(const std::string & scope, const std::string & event_name, const Binding & binding, long micros) {
+  BindingCounters & counters = binding.getCounters();
+  if(!counters.enrolled.load(boost::memory_order_acquire)) {
+    std::string prefix = scope + ";" + event_name + ";";
+    this->enroll(prefix + binding.getName(), binding.isLabeled() ? "" : prefix + "#retired", binding.shareCounters());
+  }
+  if(this->count(counters, micros)) {
+    this->reportSlow(scope, event_name, binding.getName(), micros);
+  }
+}
+
+
+/* Stats per binding name, bindings that share a label are added up */
+map_callback_stats CallbackProfiler::getStats() {
+  map_callback_stats stats;
+  boost::lock_guard<boost::mutex> guard(this->profiler_mutex);
+  this->prune();
+  for(map_profile_entries::iterator it = this->entries.begin(); it != this->entries.end(); ++it) {
+    CallbackStats sum;
+    add(sum, it->second.retired);
+    for(std::size_t i = 0; i < it->second.live.size(); i++) {
+      add(sum, *it->second.live[i]);
+    }
+    if(sum.calls > 0) {
+      stats[it->first] = sum;
+    }
+  }
+  return stats;
+}
+
+
+/* One line per binding: scope;event;binding and its total microseconds, the folded format of flamegraph.pl */
+std::string CallbackProfiler::exportFolded() {
+  std::string folded;
+  map_callback_stats stats = this->getStats();
+  for(map_callback_stats::iterator it = stats.begin(); it != stats.end(); ++it) {
+    folded += it->first + " " + boost::lexical_cast<std::string>(it->second.total) + "\n";
+  }
+  return folded;
+}
+
+
+/* Zero the counters, bindings stay enrolled */
+void CallbackProfiler::reset() {
+  boost::lock_guard<boost::mutex> guard(this->profiler_mutex);
+  for(map_profile_entries::iterator it = this->entries.begin(); it != this->entries.end(); ++it) {
+    it->second.retired.clear();
+    for(std::size_t i = 0; i < it->second.live.size(); i++) {
+      it->second.live[i]->clear();
+    }
+  }
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Prune once as many bindings were enrolled as were left by the last prune, so churn costs O(1) per bind */
+void CallbackProfiler::enroll(const std::string & key, const std::string & retire_to, boost::shared_ptr<BindingCounters> counters) {
+  boost::lock_guard<boost::mutex> guard(this->profiler_mutex);
+  if(counters->enrolled.exchange(true)) {
+    return;
+  }
+  ProfileEntry & entry = this->entries[key];
+  entry.live.push_back(counters);
+  entry.retire_to = retire_to;
+  if(++this->enrolls >= this->prune_at) {
+    this->prune();
+  }
+}
+
+
+/* Fold the counters only the profiler still holds, their bindings are gone. Called with the lock held */
+void CallbackProfiler::prune() {
+  std::size_t live = 0;
+  for(map_profile_entries::iterator it = this->entries.begin(); it != this->entries.end();) {
+    ProfileEntry & entry = it->second;
+    for(std::size_t i = 0; i < entry.live.size();) {
+      if(entry.live[i].use_count() == 1) {
+        entry.retired.add(*entry.live[i]);
+        entry.live[i] = entry.live.back();
+        entry.live.pop_back();
+      } else {
+        i++;
+      }
+    }
+    live += entry.live.size();
+    if(entry.live.empty() && !entry.retire_to.empty()) {
+      this->entries[entry.retire_to].retired.add(entry.retired);
+      this->entries.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  this->enrolls = 0;
+  this->prune_at = std::max<std::size_t>(live, PROFILER_PRUNE_MIN);
+}
+
+
+void CallbackProfiler::add(CallbackStats & sum, const BindingCounters & counters) {
+  sum.calls += counters.calls;
+  sum.total += counters.total;
+  sum.max = std::max(sum.max, counters.max.load());
+  sum.slow += counters.slow;
+  for(std::size_t i = 0; i < CALLBACK_HISTOGRAM_BUCKETS; i++) {
+    sum.histogram[i] += counters.histogram[i];
+  }
+}
+
+
+/* Count a call, returns true if it was over the budget */
+bool CallbackProfiler::count(BindingCounters & counters, long micros) {
+  counters.calls.fetch_add(1, boost::memory_order_relaxed);
+  counters.total.fetch_add(micros, boost::memory_order_relaxed);
+  long max = counters.max.load(boost::memory_order_relaxed);
+  while(micros > max && !counters.max.compare_exchange_weak(max, micros, boost::memory_order_relaxed)) {}
+  std::size_t bucket = 0;
+  for(unsigned long v = micros + 1; v > 1 && bucket + 1 < CALLBACK_HISTOGRAM_BUCKETS; v >>= 1) {
+    bucket++;
+  }
+  counters.histogram[bucket].fetch_add(1, boost::memory_order_relaxed);
+  long budget = this->budget.load(boost::memory_order_relaxed);
+  if(budget > 0 && micros > budget) {
+    counters.slow.fetch_add(1, boost::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+
+void CallbackProfiler::reportSlow(const std::string & scope, const std::string & event_name, const std::string & binding, long micros) {
+  slow_cb_func hook;
+  {
+    boost::lock_guard<boost::mutex> guard(this->profiler_mutex);
+    hook = this->on_slow;
+  }
+  if(hook) {
+    hook(scope, event_name, binding, micros);
+  }
+}
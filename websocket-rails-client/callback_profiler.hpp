@@ -0,0 +1,115 @@
+/**
+ *
+ * Name        : callback_profiler.hpp
+ * Version     : v0.7.4
+ * Description : CallbackProfiler Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef CALLBACK_PROFILER_HPP_
+#define CALLBACK_PROFILER_HPP_
+
+#include "websocket.hpp"
+#include "binding.hpp"
+
+/**
+ *  Invocation counters and execution times of one binding, in microseconds.
+ *  Bucket i of the histogram counts calls that took [2^i - 1, 2^(i+1) - 1).
+ **/
+struct CallbackStats {
+  CallbackStats() : calls(0), total(0), max(0), slow(0) { std::memset(this->histogram, 0, sizeof(this->histogram)); }
+  unsigned long calls;
+  long total;
+  long max;
+  unsigned long slow;           /* Calls over the budget */
+  unsigned long histogram[CALLBACK_HISTOGRAM_BUCKETS];
+};
+
+/**
+ *  Counters of the bindings profiled under one name. Those of bindings
+ *  that are gone are added to retired; once none is left, an entry with
+ *  a retire_to name hands its sums on to that entry and is dropped.
+ **/
+struct ProfileEntry {
+  BindingCounters retired;
+  std::vector<boost::shared_ptr<BindingCounters> > live;
+  std::string retire_to;        /* scope;event;#retired for bindings without a label, empty to keep the entry */
+};
+
+typedef std::map<std::string, CallbackStats> map_callback_stats;
+typedef std::map<std::string, ProfileEntry> map_profile_entries;
+typedef boost::function<void(std::string, std::string, std::string, long)> slow_cb_func;
+
+/**
+ *  Times the callbacks of a dispatcher per binding. A binding is named
+ *  scope;event;binding, with the channel name (or "events" and "results"
+ *  for callbacks bound on the dispatcher and result callbacks) as scope
+ *  and the label or #id of the binding, so the summary folds into a flame
+ *  graph. A call only updates the counters of its binding; the profiler
+ *  takes its lock the first time it sees a binding and for slow calls.
+ *  The counters of unbound bindings are folded into their name, those of
+ *  bindings without a label into scope;event;#retired.
+ **/
+class CallbackProfiler {
+public:
+
+  /**
+   *  Constructors
+   **/
+  CallbackProfiler();
+
+  /**
+   *  Functions
+   **/
+  void setBudget(long micros);
+  long getBudget();
+  void onSlow(slow_cb_func callback);
+  void dispatch(const std::string & scope, const std::string & event_name, const vec_cb_func & callbacks, const jsonxx::Object & event_data);
+  void record(const std::string & scope, const std::string & event_name, const std::string & binding, long micros);
+  void record(const std::string & scope, const std::string & event_name, const Binding & binding, long micros);
+  map_callback_stats getStats();
+  std::string exportFolded();
+  void reset();
+
+private:
+
+  /**
+   *  Variables
+   **/
+  boost::atomic<long> budget;   /* 0 for no budget */
+  slow_cb_func on_slow;
+  map_profile_entries entries;  /* Map<key,value>: scope;event;binding, Counters of the bindings of that name */
+  std::size_t enrolls;          /* Bindings enrolled since the last prune */
+  std::size_t prune_at;
+  boost::mutex profiler_mutex;
+
+  /**
+   *  Functions
+   **/
+  void enroll(const std::string & key, const std::string & retire_to, boost::shared_ptr<BindingCounters> counters);
+  void prune();
+  static void add(CallbackStats & sum, const BindingCounters & counters);
+  bool count(BindingCounters & counters, long micros);
+  void reportSlow(const std::string & scope, const std::string & event_name, const std::string & binding, long micros);
+
+};
+
+
+#endif /* CALLBACK_PROFILER_HPP_ */
@@ -0,0 +1,140 @@
+/**
+ *
+ * Name        : callback_table.cpp
+ * Version     : v0.7.4
+ * Description : CallbackTable Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "callback_table.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+CallbackTable::CallbackTable() : snapshot(boost::make_shared<const CallbackSnapshot>()) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+bool CallbackSnapshot::has(const std::string & event_name) const {
+  return this->callbacks.find(event_name) != this->callbacks.end() || this->filtered_callbacks.find(event_name) != this->filtered_callbacks.end();
+}
+
+
+/* Whether select() needs the event data */
+bool CallbackSnapshot::isFiltered(const std::string & event_name) const {
+  return this->filtered_callbacks.find(event_name) != this->filtered_callbacks.end();
+}
+
+
+/* Callbacks to run for an event, NULL if there are none. Without filtered callbacks this is the
+   snapshot's own array; otherwise matched gets the callbacks and the filtered ones that match */
+const vec_cb_func * CallbackSnapshot::select(const std::string & event_name, StringRef event_data, vec_cb_func & matched) const {
+  map_vec_cb_func::const_iterator found = this->callbacks.find(event_name);
+  map_vec_filtered_cb::const_iterator filtered = this->filtered_callbacks.find(event_name);
+  if(filtered == this->filtered_callbacks.end()) {
+    return found != this->callbacks.end() && !found->second.empty() ? &found->second : NULL;
+  }
+  if(found != this->callbacks.end()) {
+    matched = found->second;
+  }
+  for(vec_filtered_cb::const_iterator it = filtered->second.begin(); it != filtered->second.end(); ++it) {
+    if(it->filter.matches(event_data)) {
+      matched.push_back(it->callback);
+    }
+  }
+  return matched.empty() ? NULL : &matched;
+}
+
+
+/* The current snapshot, it stays valid for as long as it is held */
+boost::shared_ptr<const CallbackSnapshot> CallbackTable::load() const {
+  return boost::atomic_load(&this->snapshot);
+}
+
+
+void CallbackTable::bind(std::string event_name, cb_ptr callback) {
+  boost::lock_guard<boost::mutex> guard(this->write_mutex);
+  boost::shared_ptr<CallbackSnapshot> next = boost::make_shared<CallbackSnapshot>(*this->snapshot);
+  next->callbacks[event_name].push_back(callback);
+  this->publish(next);
+}
+
+
+void CallbackTable::bind(std::string event_name, EventFilter filter, cb_ptr callback) {
+  boost::lock_guard<boost::mutex> guard(this->write_mutex);
+  boost::shared_ptr<CallbackSnapshot> next = boost::make_shared<CallbackSnapshot>(*this->snapshot);
+  next->filtered_callbacks[event_name].push_back(FilteredCallback(filter, callback));
+  this->publish(next);
+}
+
+
+void CallbackTable::unbindAll(std::string event_name) {
+  boost::lock_guard<boost::mutex> guard(this->write_mutex);
+  if(!this->snapshot->has(event_name)) {
+    return;
+  }
+  boost::shared_ptr<CallbackSnapshot> next = boost::make_shared<CallbackSnapshot>(*this->snapshot);
+  next->callbacks.erase(event_name);
+  next->filtered_callbacks.erase(event_name);
+  this->publish(next);
+}
+
+
+void CallbackTable::clear() {
+  boost::lock_guard<boost::mutex> guard(this->write_mutex);
+  this->publish(boost::make_shared<CallbackSnapshot>());
+}
+
+
+void CallbackTable::setCallbacks(map_vec_cb_func callbacks) {
+  boost::lock_guard<boost::mutex> guard(this->write_mutex);
+  boost::shared_ptr<CallbackSnapshot> next = boost::make_shared<CallbackSnapshot>(*this->snapshot);
+  next->callbacks = callbacks;
+  this->publish(next);
+}
+
+
+void CallbackTable::setFilteredCallbacks(map_vec_filtered_cb filtered_callbacks) {
+  boost::lock_guard<boost::mutex> guard(this->write_mutex);
+  boost::shared_ptr<CallbackSnapshot> next = boost::make_shared<CallbackSnapshot>(*this->snapshot);
+  next->filtered_callbacks = filtered_callbacks;
+  this->publish(next);
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Swap a new snapshot in, called with write_mutex held */
+void CallbackTable::publish(boost::shared_ptr<CallbackSnapshot> next) {
+  boost::shared_ptr<const CallbackSnapshot> published = next;
+  boost::atomic_store(&this->snapshot, published);
+}
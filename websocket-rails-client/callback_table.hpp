@@ -0,0 +1,86 @@
+/**
+ *
+ * Name        : callback_table.hpp
+ * Version     : v0.7.4
+ * Description : CallbackTable Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef CALLBACK_TABLE_HPP_
+#define CALLBACK_TABLE_HPP_
+
+#include "websocket.hpp"
+#include "event_filter.hpp"
+
+/**
+ *  Immutable state of a callback table, shared by the dispatching threads.
+ **/
+struct CallbackSnapshot {
+  map_vec_cb_func callbacks;                 /* Map<key,value>: Event Name, Callback Array          */
+  map_vec_filtered_cb filtered_callbacks;    /* Map<key,value>: Event Name, Filtered Callback Array */
+
+  bool has(const std::string & event_name) const;
+  bool isFiltered(const std::string & event_name) const;
+  const vec_cb_func * select(const std::string & event_name, StringRef event_data, vec_cb_func & matched) const;
+};
+
+/**
+ *  Callbacks by event name, published as immutable snapshots (read-copy-
+ *  update). Dispatch loads the current snapshot and runs its callbacks
+ *  without a lock or a copy; bind and unbind copy the snapshot, change the
+ *  copy and swap it in atomically. A snapshot is freed when the last
+ *  dispatch holding it is done.
+ **/
+class CallbackTable {
+public:
+
+  /**
+   *  Constructors
+   **/
+  CallbackTable();
+
+  /**
+   *  Functions
+   **/
+  boost::shared_ptr<const CallbackSnapshot> load() const;
+  void bind(std::string event_name, cb_ptr callback);
+  void bind(std::string event_name, EventFilter filter, cb_ptr callback);
+  void unbindAll(std::string event_name);
+  void clear();
+  void setCallbacks(map_vec_cb_func callbacks);
+  void setFilteredCallbacks(map_vec_filtered_cb filtered_callbacks);
+
+private:
+
+  /**
+   *  Variables
+   **/
+  boost::shared_ptr<const CallbackSnapshot> snapshot;
+  boost::mutex write_mutex;                  /* Serializes writers, readers never take it */
+
+  /**
+   *  Functions
+   **/
+  void publish(boost::shared_ptr<CallbackSnapshot> next);
+
+};
+
+
+#endif /* CALLBACK_TABLE_HPP_ */
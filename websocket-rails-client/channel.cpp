@@ -31,18 +31,18 @@
  *  Constructors                    *
  ************************************/
 
-Channel::Channel() : is_private(false), dispatcher() {}
+Channel::Channel() : is_private(false), table(boost::make_shared<CallbackTable>()), dispatcher() {}
 
 
-Channel::Channel(std::string name, WebsocketRails & dispatcher, bool is_private) : is_private(is_private), name(name) {
+Channel::Channel(std::string name, WebsocketRails & dispatcher, bool is_private) : is_private(is_private), name(name), table(boost::make_shared<CallbackTable>()) {
   this->dispatcher = &dispatcher;
   this->initObject();
 }
 
 
-Channel::Channel(std::string name, WebsocketRails & dispatcher, bool is_private, cb_func on_success, cb_func on_failure) : is_private(is_private), name(name) {
-  this->on_success = on_success;
-  this->on_failure = on_failure;
+Channel::Channel(std::string name, WebsocketRails & dispatcher, bool is_private, cb_func on_success, cb_func on_failure) : is_private(is_private), name(name), table(boost::make_shared<CallbackTable>()) {
+  this->on_success = std::move(on_success);
+  this->on_failure = std::move(on_failure);
   this->dispatcher = &dispatcher;
   this->initObject();
 }
@@ -57,29 +57,50 @@ void Channel::destroy(cb_func success_callback, cb_func failure_callback) {
   if(this->connection_id == (this->dispatcher->getConn() != NULL ? this->dispatcher->getConn()->getConnectionId() : "")) {
     std::string event_name = "websocket_rails.unsubscribe";
     jsonxx::Array data = this->initEventData(event_name);
-    Event event(data, success_callback, failure_callback);
-    this->dispatcher->triggerEvent(event);
+    Event event(data);
+    this->dispatcher->triggerEvent(event, std::move(success_callback), std::move(failure_callback));
   }
-  this->callbacks.clear();
+  this->table->clear();
 }
 
 
 void Channel::bind(std::string event_name, cb_func callback) {
-  if(this->callbacks.find(event_name) == this->callbacks.end()) {
-    vec_cb_func v;
-    this->callbacks[event_name] = v;
+  this->bind(event_name, std::move(callback), "");
+}
+
+
+/* Bind with a label the profiler reports the callback under */
+void Channel::bind(std::string event_name, cb_func callback, std::string label) {
+  cb_ptr bound = boost::make_shared<const Binding>(std::move(callback), label);
+  this->table->bind(event_name, bound);
+  boost::shared_ptr<Conflator> conflator = this->getConflator();
+  if(conflator) {
+    conflator->replay(event_name, bound, this->dispatcher->shareProfiler());
   }
-  this->callbacks[event_name].push_back(callback);
 }
 
 
-void Channel::unbindAll(std::string event_name) {
-  if(this->callbacks.find(event_name) != this->callbacks.end()) {
-    this->callbacks.erase(event_name);
+/* Bind a callback that only gets the events its filter matches, non-matching events are never parsed */
+void Channel::bind(std::string event_name, EventFilter filter, cb_func callback) {
+  this->bind(event_name, filter, std::move(callback), "");
+}
+
+
+void Channel::bind(std::string event_name, EventFilter filter, cb_func callback, std::string label) {
+  cb_ptr bound = boost::make_shared<const Binding>(std::move(callback), label);
+  this->table->bind(event_name, filter, bound);
+  boost::shared_ptr<Conflator> conflator = this->getConflator();
+  if(conflator) {
+    conflator->replay(event_name, filter, bound, this->dispatcher->shareProfiler());
   }
 }
 
 
+void Channel::unbindAll(std::string event_name) {
+  this->table->unbindAll(event_name);
+}
+
+
 void Channel::trigger(std::string event_name, jsonxx::Object event_data) {
   jsonxx::Array data = this->initEventData(event_name);
   data.get<jsonxx::Object>(1).import("channel", this->name);
@@ -99,13 +120,61 @@ std::string Channel::getName() {
 }
 
 
+std::string Channel::getToken() {
+  return this->token;
+}
+
+
+/* Use a channel token obtained earlier, e.g. handed over by another process; sends the queued events */
+void Channel::setToken(std::string token) {
+  this->connection_id = this->dispatcher->getConn() != NULL ? this->dispatcher->getConn()->getConnectionId() : "";
+  this->token = token;
+  this->flush_queue();
+}
+
+
+/* Take the events waiting for the channel token */
+std::queue<Event> Channel::takeQueue() {
+  std::queue<Event> queued;
+  std::swap(this->event_queue, queued);
+  return queued;
+}
+
+
+/* Put events taken with takeQueue back ahead of the ones queued since, sent at once if the token arrived meanwhile */
+void Channel::restoreQueue(std::queue<Event> queued) {
+  for(; !this->event_queue.empty(); this->event_queue.pop()) {
+    queued.push(this->event_queue.front());
+  }
+  std::swap(this->event_queue, queued);
+  if(!this->token.empty()) {
+    this->flush_queue();
+  }
+}
+
+
 map_vec_cb_func Channel::getCallbacks() {
-  return this->callbacks;
+  return this->table->load()->callbacks;
 }
 
 
 void Channel::setCallbacks(map_vec_cb_func callbacks) {
-  this->callbacks = callbacks;
+  this->table->setCallbacks(callbacks);
+}
+
+
+map_vec_filtered_cb Channel::getFilteredCallbacks() {
+  return this->table->load()->filtered_callbacks;
+}
+
+
+void Channel::setFilteredCallbacks(map_vec_filtered_cb filtered_callbacks) {
+  this->table->setFilteredCallbacks(filtered_callbacks);
+}
+
+
+boost::shared_ptr<CallbackTable> Channel::getCallbackTable() {
+  return this->table;
 }
 
 
@@ -114,25 +183,97 @@ bool Channel::isPrivate() {
 }
 
 
+/* True if the data of an event is used even when no callback takes it */
+bool Channel::keepsData(const std::string & event_name) {
+  return this->getConflator() || event_name == "websocket_rails.channel_token";
+}
+
+
 void Channel::dispatch(std::string event_name, jsonxx::Object event_data) {
+  boost::shared_ptr<const CallbackSnapshot> snapshot = this->table->load();
+  vec_cb_func matched;
+  const vec_cb_func * event_callbacks = NULL;
+  if(snapshot->isFiltered(event_name)) {
+    std::string json = event_data.json();
+    event_callbacks = snapshot->select(event_name, StringRef(json.data(), json.size()), matched);
+  } else {
+    event_callbacks = snapshot->select(event_name, StringRef(), matched);
+  }
+  this->dispatch(event_name, event_data, event_callbacks != NULL ? *event_callbacks : matched);
+}
+
+
+void Channel::dispatch(std::string event_name, jsonxx::Object event_data, const vec_cb_func & event_callbacks) {
   if(event_name == "websocket_rails.channel_token") {
     this->connection_id =  this->dispatcher->getConn() != NULL ? this->dispatcher->getConn()->getConnectionId() : "";
     this->token = event_data.get<jsonxx::String>("token");
     this->flush_queue();
   } else {
-    if(this->callbacks.find(event_name) == this->callbacks.end()) {
+    boost::shared_ptr<Conflator> conflator = this->getConflator();
+    if(conflator) {
+      conflator->push(event_name, event_data, event_callbacks, this->dispatcher->shareProfiler());
+      return;
+    }
+    if(this->dispatcher->getProfiler() != NULL) {
+      this->dispatcher->getProfiler()->dispatch(this->name, event_name, event_callbacks, event_data);
       return;
     }
-    vec_cb_func event_callbacks = this->callbacks[event_name];
-    for(vec_cb_func::iterator it = event_callbacks.begin(); it != event_callbacks.end(); ++it) {
-      cb_func callback = *it;
-      callback(event_data);
+    for(vec_cb_func::const_iterator it = event_callbacks.begin(); it != event_callbacks.end(); ++it) {
+      (**it)(event_data);
     }
   }
 }
 
 
 
+/* Deliver only the newest pending value per event name, on the delivery thread of the dispatcher */
+void Channel::conflate() {
+  this->conflate("");
+}
+
+
+/* Deliver only the newest pending value per event name and value of a data field */
+void Channel::conflate(std::string key_field) {
+  this->setConflator(boost::make_shared<Conflator>(this->name, key_field, this->dispatcher->getDeliveryExecutor()));
+}
+
+
+bool Channel::isConflated() {
+  return this->getConflator() != NULL;
+}
+
+
+/* Latest value of an event name on a conflated channel */
+bool Channel::getLastValue(std::string event_name, jsonxx::Object & event_data) {
+  return this->getLastValue(event_name, "", event_data);
+}
+
+
+/* Latest value of an event name and key field value on a conflated channel */
+bool Channel::getLastValue(std::string event_name, std::string key, jsonxx::Object & event_data) {
+  boost::shared_ptr<Conflator> conflator = this->getConflator();
+  return conflator ? conflator->getLastValue(event_name, key, event_data) : false;
+}
+
+
+ConflationStats Channel::getConflationStats() {
+  boost::shared_ptr<Conflator> conflator = this->getConflator();
+  return conflator ? conflator->getStats() : ConflationStats();
+}
+
+
+/* The conflator is swapped atomically, conflate() may race with dispatch on the IO thread */
+boost::shared_ptr<Conflator> Channel::getConflator() {
+  return boost::atomic_load(&this->conflator);
+}
+
+
+void Channel::setConflator(boost::shared_ptr<Conflator> conflator) {
+  boost::atomic_store(&this->conflator, conflator);
+}
+
+
+
 /********************************************************
  *                                                      *
  * PRIVATE METHODS                                      *
@@ -148,8 +289,9 @@ void Channel::initObject() {
   }
   this->connection_id = this->dispatcher->getConn() != NULL ? this->dispatcher->getConn()->getConnectionId() : "";
   jsonxx::Array data = this->initEventData(event_name);
-  Event event(data, this->on_success, this->on_failure);
-  this->dispatcher->triggerEvent(event);
+  Event event(data);
+  /* The subscribe result is delivered once, the callbacks go with it */
+  this->dispatcher->triggerEvent(event, std::move(this->on_success), std::move(this->on_failure));
 }
 
 
@@ -29,6 +29,9 @@ class WebsocketRails;
 
 #include "websocket.hpp"
 #include "event.hpp"
+#include "conflator.hpp"
+#include "event_filter.hpp"
+#include "callback_table.hpp"
 
 class Channel {
 public:
@@ -45,15 +48,36 @@ public:
    **/
   void destroy(cb_func success_callback, cb_func failure_callback);
   void bind(std::string event_name, cb_func callback);
+  void bind(std::string event_name, cb_func callback, std::string label);
+  void bind(std::string event_name, EventFilter filter, cb_func callback);
+  void bind(std::string event_name, EventFilter filter, cb_func callback, std::string label);
   void unbindAll(std::string event_name);
   void trigger(std::string event_name, jsonxx::Object event_data);
   std::string getName();
+  std::string getToken();
+  void setToken(std::string token);
+  std::queue<Event> takeQueue();
+  void restoreQueue(std::queue<Event> queued);
   map_vec_cb_func getCallbacks();
   void setCallbacks(map_vec_cb_func callbacks);
+  map_vec_filtered_cb getFilteredCallbacks();
+  void setFilteredCallbacks(map_vec_filtered_cb filtered_callbacks);
+  boost::shared_ptr<CallbackTable> getCallbackTable();
   bool isPrivate();
+  bool keepsData(const std::string & event_name);
   void dispatch(std::string event_name, jsonxx::Object event_data);
+  void dispatch(std::string event_name, jsonxx::Object event_data, const vec_cb_func & event_callbacks);
+  void conflate();
+  void conflate(std::string key_field);
+  bool isConflated();
+  bool getLastValue(std::string event_name, jsonxx::Object & event_data);
+  bool getLastValue(std::string event_name, std::string key, jsonxx::Object & event_data);
+  ConflationStats getConflationStats();
+  boost::shared_ptr<Conflator> getConflator();
+  void setConflator(boost::shared_ptr<Conflator> conflator);
 
 private:
+  friend class WebsocketRails;
 
   /**
    *  Variables
@@ -64,9 +88,10 @@ private:
   std::string token;
   cb_func on_success;
   cb_func on_failure;
-  map_vec_cb_func callbacks;       /* Map<key,value>: Event Name, Callback Array */
+  boost::shared_ptr<CallbackTable> table;   /* Shared by the copies of the channel */
   std::queue<Event> empty;
   std::queue<Event> event_queue;
+  boost::shared_ptr<Conflator> conflator;   /* Shared by the copies of the channel, NULL unless conflated */
   WebsocketRails * dispatcher;
 
   /**
@@ -78,5 +103,7 @@ private:
 
 };
 
+typedef std::tr1::unordered_map<std::string, boost::shared_ptr<Channel> > map_channel;
+
 
 #endif /* CHANNEL_HPP_ */
@@ -0,0 +1,227 @@
+/**
+ *
+ * Name        : conflator.cpp
+ * Version     : v0.7.4
+ * Description : Conflator Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "conflator.hpp"
+
+
+
+/* A value waiting for delivery, the callbacks bound when it arrived and the profiler to time them, if any */
+struct ConflatedEvent {
+  std::string event_name;
+  jsonxx::Object event_data;
+  vec_cb_func callbacks;
+  boost::shared_ptr<CallbackProfiler> profiler;
+};
+
+
+struct Conflator::State {
+  State(std::string scope, std::string key_field, boost::shared_ptr<DeliveryExecutor> executor) : scope(scope), key_field(key_field), executor(executor), stopped(false), scheduled(false) {}
+  std::string scope;
+  std::string key_field;
+  boost::weak_ptr<DeliveryExecutor> executor;                       /* Weak, its queue holds the state */
+  bool stopped;
+  bool scheduled;                                                   /* A delivery is posted            */
+  boost::mutex mutex;
+  std::tr1::unordered_map<std::string, ConflatedEvent> pending;     /* Map<key,value>: Key, Newest Value */
+  std::deque<std::string> order;                                    /* Keys in order of first arrival    */
+  std::deque<ConflatedEvent> replays;
+  std::tr1::unordered_map<std::string, jsonxx::Object> cache;       /* Map<key,value>: Key, Last Value   */
+  ConflationStats stats;
+};
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+Conflator::Conflator(std::string scope, std::string key_field, boost::shared_ptr<DeliveryExecutor> executor) : state(boost::make_shared<State>(scope, key_field, executor)), executor(executor) {}
+
+
+/* Values not delivered yet are dropped */
+Conflator::~Conflator() {
+  boost::lock_guard<boost::mutex> guard(this->state->mutex);
+  this->state->stopped = true;
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Store a value under its key, replacing the undelivered value of that key */
+void Conflator::push(std::string event_name, jsonxx::Object event_data, vec_cb_func callbacks, boost::shared_ptr<CallbackProfiler> profiler) {
+  std::string key;
+  if(!this->state->key_field.empty()) {
+    if(event_data.has<jsonxx::String>(this->state->key_field)) {
+      key = event_data.get<jsonxx::String>(this->state->key_field);
+    } else if(event_data.has<jsonxx::Number>(this->state->key_field)) {
+      key = boost::lexical_cast<std::string>(event_data.get<jsonxx::Number>(this->state->key_field));
+    }
+  }
+  key = makeKey(event_name, key);
+  {
+    boost::lock_guard<boost::mutex> guard(this->state->mutex);
+    State & s = *this->state;
+    s.stats.received++;
+    s.cache[key] = event_data;
+    s.stats.cached = s.cache.size();
+    if(callbacks.empty()) {
+      return;
+    }
+    std::tr1::unordered_map<std::string, ConflatedEvent>::iterator found = s.pending.find(key);
+    if(found != s.pending.end()) {
+      found->second.event_data = event_data;
+      found->second.callbacks = callbacks;
+      found->second.profiler = profiler;
+      s.stats.conflated++;
+      return;
+    }
+    ConflatedEvent & event = s.pending[key];
+    event.event_name = event_name;
+    event.event_data = event_data;
+    event.callbacks = callbacks;
+    event.profiler = profiler;
+    s.order.push_back(key);
+    s.stats.pending = s.pending.size();
+  }
+  schedule(this->state);
+}
+
+
+/* Hand the cached values of an event name to a callback bound late */
+void Conflator::replay(std::string event_name, cb_ptr callback, boost::shared_ptr<CallbackProfiler> profiler) {
+  this->replay(event_name, EventFilter(), callback, profiler);
+}
+
+
+/* Hand the cached values of an event name that match a filter to a callback bound late */
+void Conflator::replay(std::string event_name, EventFilter filter, cb_ptr callback, boost::shared_ptr<CallbackProfiler> profiler) {
+  std::string prefix = makeKey(event_name, "");
+  {
+    boost::lock_guard<boost::mutex> guard(this->state->mutex);
+    State & s = *this->state;
+    for(std::tr1::unordered_map<std::string, jsonxx::Object>::iterator it = s.cache.begin(); it != s.cache.end(); ++it) {
+      if(it->first.compare(0, prefix.size(), prefix) == 0 && (filter.empty() || filter.matches(it->second))) {
+        ConflatedEvent event;
+        event.event_name = event_name;
+        event.event_data = it->second;
+        event.callbacks.push_back(callback);
+        event.profiler = profiler;
+        s.replays.push_back(event);
+      }
+    }
+  }
+  schedule(this->state);
+}
+
+
+/* Latest value of an event name, and of a key field value if the channel is keyed by a field */
+bool Conflator::getLastValue(std::string event_name, std::string key, jsonxx::Object & event_data) {
+  boost::lock_guard<boost::mutex> guard(this->state->mutex);
+  std::tr1::unordered_map<std::string, jsonxx::Object>::iterator found = this->state->cache.find(makeKey(event_name, key));
+  if(found == this->state->cache.end()) {
+    return false;
+  }
+  event_data = found->second;
+  return true;
+}
+
+
+std::string Conflator::getKeyField() {
+  return this->state->key_field;
+}
+
+
+ConflationStats Conflator::getStats() {
+  boost::lock_guard<boost::mutex> guard(this->state->mutex);
+  return this->state->stats;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Post a delivery unless one is posted already */
+void Conflator::schedule(boost::shared_ptr<State> state) {
+  boost::shared_ptr<DeliveryExecutor> executor;
+  {
+    boost::lock_guard<boost::mutex> guard(state->mutex);
+    if(state->scheduled || state->stopped || (state->order.empty() && state->replays.empty())) {
+      return;
+    }
+    executor = state->executor.lock();
+    state->scheduled = executor != NULL;
+  }
+  if(executor) {
+    executor->post(boost::bind(&Conflator::deliver, state));
+  }
+}
+
+
+/* Deliver one value on the delivery thread without the lock held, then queue up behind the other channels */
+void Conflator::deliver(boost::shared_ptr<State> state) {
+  ConflatedEvent event;
+  {
+    boost::lock_guard<boost::mutex> guard(state->mutex);
+    if(state->stopped || (state->order.empty() && state->replays.empty())) {
+      state->scheduled = false;
+      return;
+    }
+    if(!state->replays.empty()) {
+      event = state->replays.front();
+      state->replays.pop_front();
+    } else {
+      std::string key = state->order.front();
+      state->order.pop_front();
+      event = state->pending[key];
+      state->pending.erase(key);
+      state->stats.pending = state->pending.size();
+    }
+  }
+  if(event.profiler) {
+    event.profiler->dispatch(state->scope, event.event_name, event.callbacks, event.event_data);
+  } else {
+    for(vec_cb_func::iterator it = event.callbacks.begin(); it != event.callbacks.end(); ++it) {
+      (**it)(event.event_data);
+    }
+  }
+  {
+    boost::lock_guard<boost::mutex> guard(state->mutex);
+    state->stats.delivered++;
+    state->scheduled = false;
+  }
+  schedule(state);
+}
+
+
+std::string Conflator::makeKey(std::string event_name, std::string key) {
+  return event_name + '\0' + key;
+}
@@ -0,0 +1,95 @@
+/**
+ *
+ * Name        : conflator.hpp
+ * Version     : v0.7.4
+ * Description : Conflator Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef CONFLATOR_HPP_
+#define CONFLATOR_HPP_
+
+#include "websocket.hpp"
+#include "event_filter.hpp"
+#include "delivery_executor.hpp"
+#include "callback_profiler.hpp"
+
+/**
+ *  Conflation counters of a channel.
+ **/
+struct ConflationStats {
+  ConflationStats() : pending(0), received(0), delivered(0), conflated(0), cached(0) {}
+  std::size_t pending;          /* Keys waiting for delivery            */
+  unsigned long received;
+  unsigned long delivered;
+  unsigned long conflated;      /* Values replaced before delivery      */
+  std::size_t cached;           /* Keys in the last-value cache         */
+};
+
+/**
+ *  Keeps only the newest undelivered value per key and hands it to the
+ *  callbacks on the delivery thread of the dispatcher, so a slow consumer
+ *  skips stale values instead of falling behind. The key is the event
+ *  name, or the event name and a field of the data. The latest value of
+ *  every key stays in a last-value cache. With a profiler, deliveries are
+ *  timed under the scope of the conflator, the name of its channel.
+ **/
+class Conflator {
+public:
+
+  /**
+   *  Constructors
+   **/
+  Conflator(std::string scope, std::string key_field, boost::shared_ptr<DeliveryExecutor> executor);
+  ~Conflator();
+
+  /**
+   *  Functions
+   **/
+  void push(std::string event_name, jsonxx::Object event_data, vec_cb_func callbacks, boost::shared_ptr<CallbackProfiler> profiler);
+  void replay(std::string event_name, cb_ptr callback, boost::shared_ptr<CallbackProfiler> profiler);
+  void replay(std::string event_name, EventFilter filter, cb_ptr callback, boost::shared_ptr<CallbackProfiler> profiler);
+  bool getLastValue(std::string event_name, std::string key, jsonxx::Object & event_data);
+  std::string getKeyField();
+  ConflationStats getStats();
+
+private:
+
+  struct State;
+
+  /**
+   *  Variables
+   **/
+  boost::shared_ptr<State> state;  /* Shared with the delivery thread, it may outlive the conflator */
+  boost::shared_ptr<DeliveryExecutor> executor;
+
+  /**
+   *  Functions
+   **/
+  Conflator(const Conflator &);
+  Conflator & operator=(const Conflator &);
+  static void schedule(boost::shared_ptr<State> state);
+  static void deliver(boost::shared_ptr<State> state);
+  static std::string makeKey(std::string event_name, std::string key);
+
+};
+
+
+#endif /* CONFLATOR_HPP_ */
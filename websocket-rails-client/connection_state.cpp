@@ -0,0 +1,133 @@
+/**
+ *
+ * Name        : connection_state.cpp
+ * Version     : v0.7.4
+ * Description : ConnectionStateMachine Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "connection_state.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+ConnectionStateMachine::ConnectionStateMachine() : state(STATE_DISCONNECTED), transitions(0), hooked(false) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+ConnectionState ConnectionStateMachine::get() {
+  return this->state.load(boost::memory_order_acquire);
+}
+
+
+bool ConnectionStateMachine::is(ConnectionState state) {
+  return this->get() == state;
+}
+
+
+/* Move to a state from whatever state is current, if that transition is allowed */
+bool ConnectionStateMachine::transition(ConnectionState to) {
+  ConnectionState from = this->get();
+  do {
+    if(!isAllowed(from, to)) {
+      return false;
+    }
+  } while(!this->state.compare_exchange_weak(from, to, boost::memory_order_acq_rel, boost::memory_order_acquire));
+  this->fire(from, to);
+  return true;
+}
+
+
+/* Move to a state only if the current state is the expected one */
+bool ConnectionStateMachine::transition(ConnectionState from, ConnectionState to) {
+  if(!isAllowed(from, to) || !this->state.compare_exchange_strong(from, to, boost::memory_order_acq_rel, boost::memory_order_acquire)) {
+    return false;
+  }
+  this->fire(from, to);
+  return true;
+}
+
+
+/* Register a hook called with the old and the new state on every transition */
+void ConnectionStateMachine::onTransition(state_cb_func callback) {
+  boost::lock_guard<boost::mutex> guard(this->hook_mutex);
+  this->hooks.push_back(callback);
+  this->hooked = true;
+}
+
+
+unsigned long ConnectionStateMachine::getTransitions() {
+  return this->transitions.load(boost::memory_order_acquire);
+}
+
+
+bool ConnectionStateMachine::isAllowed(ConnectionState from, ConnectionState to) {
+  /* Rows are the current state, columns the next one, in enum order */
+  static const bool allowed[5][5] = {
+    /*                 DISCONNECTED CONNECTING CONNECTED RECONNECTING CLOSING */
+    /* DISCONNECTED */ { false,       true,      false,    true,        false },
+    /* CONNECTING   */ { true,        false,     true,     false,       true  },
+    /* CONNECTED    */ { true,        false,     false,    true,        true  },
+    /* RECONNECTING */ { true,        true,      false,    false,       true  },
+    /* CLOSING      */ { true,        false,     false,    false,       false }
+  };
+  return allowed[from][to];
+}
+
+
+std::string ConnectionStateMachine::toString(ConnectionState state) {
+  switch(state) {
+    case STATE_CONNECTING:   return "connecting";
+    case STATE_CONNECTED:    return "connected";
+    case STATE_RECONNECTING: return "reconnecting";
+    case STATE_CLOSING:      return "closing";
+    default:                 return "disconnected";
+  }
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+void ConnectionStateMachine::fire(ConnectionState from, ConnectionState to) {
+  this->transitions.fetch_add(1, boost::memory_order_release);
+  if(!this->hooked.load(boost::memory_order_acquire)) {
+    return;
+  }
+  std::vector<state_cb_func> callbacks;
+  {
+    boost::lock_guard<boost::mutex> guard(this->hook_mutex);
+    callbacks = this->hooks;
+  }
+  for(std::vector<state_cb_func>::iterator it = callbacks.begin(); it != callbacks.end(); ++it) {
+    (*it)(from, to);
+  }
+}
@@ -0,0 +1,86 @@
+/**
+ *
+ * Name        : connection_state.hpp
+ * Version     : v0.7.4
+ * Description : ConnectionStateMachine Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef CONNECTION_STATE_HPP_
+#define CONNECTION_STATE_HPP_
+
+#include "websocket.hpp"
+
+enum ConnectionState {
+  STATE_DISCONNECTED,
+  STATE_CONNECTING,     /* Handshake running, waiting for client_connected */
+  STATE_CONNECTED,
+  STATE_RECONNECTING,   /* Old connection being replaced by a new one      */
+  STATE_CLOSING         /* Closed by the client, connection being torn down */
+};
+
+typedef boost::function<void(ConnectionState, ConnectionState)> state_cb_func;
+
+/**
+ *  Connection state shared by the application threads and the IO thread.
+ *  Reads are a single atomic load; transitions are checked against the
+ *  allowed ones and applied with compare-and-swap. Transition hooks run on
+ *  the thread making the transition, without any lock held.
+ **/
+class ConnectionStateMachine {
+public:
+
+  /**
+   *  Constructors
+   **/
+  ConnectionStateMachine();
+
+  /**
+   *  Functions
+   **/
+  ConnectionState get();
+  bool is(ConnectionState state);
+  bool transition(ConnectionState to);
+  bool transition(ConnectionState from, ConnectionState to);
+  void onTransition(state_cb_func callback);
+  unsigned long getTransitions();
+  static bool isAllowed(ConnectionState from, ConnectionState to);
+  static std::string toString(ConnectionState state);
+
+private:
+
+  /**
+   *  Variables
+   **/
+  boost::atomic<ConnectionState> state;
+  boost::atomic<unsigned long> transitions;   /* Bumped on every transition, pollable by observers */
+  boost::atomic<bool> hooked;                 /* Skips the hook lock while nobody observes        */
+  boost::mutex hook_mutex;
+  std::vector<state_cb_func> hooks;
+
+  /**
+   *  Functions
+   **/
+  void fire(ConnectionState from, ConnectionState to);
+
+};
+
+
+#endif /* CONNECTION_STATE_HPP_ */
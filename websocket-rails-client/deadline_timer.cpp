@@ -0,0 +1,119 @@
+/**
+ *
+ * Name        : deadline_timer.cpp
+ * Version     : v0.7.4
+ * Description : DeadlineTimer Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+
+
+
+#include "deadline_timer.hpp"
+
+
+
+struct DeadlineTimer::State {
+  State(boost::asio::io_service & io_service, boost::function<void()> handler) : stopped(false), timer(io_service), handler(handler) {}
+  bool stopped;
+  std::chrono::steady_clock::time_point armed;  /* Deadline of the pending wait, the epoch if none */
+  boost::asio::steady_timer timer;
+  boost::function<void()> handler;
+  boost::mutex mutex;
+  boost::mutex run_mutex;                       /* Held while the handler runs */
+};
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+DeadlineTimer::DeadlineTimer(boost::asio::io_service * io_service, boost::function<void()> handler)
+  : own_service(io_service == NULL ? boost::make_shared<boost::asio::io_service>() : boost::shared_ptr<boost::asio::io_service>()),
+    state(boost::make_shared<State>(boost::ref(io_service == NULL ? *own_service : *io_service), handler)) {}
+
+
+/* A handler that already runs is waited for, one that did not start yet is dropped */
+DeadlineTimer::~DeadlineTimer() {
+  {
+    boost::lock_guard<boost::mutex> guard(this->state->mutex);
+    this->state->stopped = true;
+    this->state->timer.cancel();
+  }
+  if(this->own_service) {
+    this->work.reset();
+    this->own_service->stop();
+    if(this->worker.joinable()) {
+      this->worker.join();
+    }
+  }
+  boost::lock_guard<boost::mutex> running(this->state->run_mutex);
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+void DeadlineTimer::arm(std::chrono::steady_clock::time_point deadline) {
+  boost::lock_guard<boost::mutex> guard(this->state->mutex);
+  if(this->state->stopped || (this->state->armed != std::chrono::steady_clock::time_point() && this->state->armed <= deadline)) {
+    return;
+  }
+  /* An earlier deadline cancels the pending wait */
+  this->state->armed = deadline;
+  this->state->timer.expires_at(deadline);
+  this->state->timer.async_wait(boost::bind(&DeadlineTimer::fired, this->state, deadline, boost::asio::placeholders::error));
+  if(this->own_service && !this->worker.joinable()) {
+    this->work = boost::make_shared<boost::asio::io_service::work>(boost::ref(*this->own_service));
+    this->worker = boost::thread(&DeadlineTimer::run, this->own_service.get());
+  }
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+void DeadlineTimer::run(boost::asio::io_service * io_service) {
+  io_service->run();
+}
+
+
+/* A wait that was cancelled or replaced by an earlier one does nothing */
+void DeadlineTimer::fired(boost::shared_ptr<State> state, std::chrono::steady_clock::time_point deadline, const boost::system::error_code & ec) {
+  if(ec) {
+    return;
+  }
+  boost::lock_guard<boost::mutex> running(state->run_mutex);
+  {
+    boost::lock_guard<boost::mutex> guard(state->mutex);
+    if(state->stopped || state->armed != deadline) {
+      return;
+    }
+    state->armed = std::chrono::steady_clock::time_point();
+  }
+  state->handler();
+}
@@ -0,0 +1,77 @@
+/**
+ *
+ * Name        : deadline_timer.hpp
+ * Version     : v0.7.4
+ * Description : DeadlineTimer Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+
+#ifndef DEADLINE_TIMER_HPP_
+#define DEADLINE_TIMER_HPP_
+
+#include "websocket.hpp"
+#include <boost/asio/steady_timer.hpp>
+
+/**
+ *  Runs a handler at the earliest armed deadline, on the loop of the
+ *  dispatcher or, without one, on a thread of its own started by the
+ *  first arm. It needs no connection, so results time out while there is
+ *  none. A deadline later than the armed one is left to the handler,
+ *  which arms the next deadline itself.
+ **/
+class DeadlineTimer {
+public:
+
+  /**
+   *  Constructors
+   **/
+  DeadlineTimer(boost::asio::io_service * io_service, boost::function<void()> handler);
+  ~DeadlineTimer();
+
+  /**
+   *  Functions
+   **/
+  void arm(std::chrono::steady_clock::time_point deadline);
+
+private:
+
+  struct State;
+
+  /**
+   *  Variables
+   **/
+  boost::shared_ptr<boost::asio::io_service> own_service;  /* Loop of the timer thread, NULL on the loop of the dispatcher */
+  boost::shared_ptr<boost::asio::io_service::work> work;
+  boost::shared_ptr<State> state;                           /* Shared with the pending wait, it may outlive the timer */
+  boost::thread worker;
+
+  /**
+   *  Functions
+   **/
+  DeadlineTimer(const DeadlineTimer &);
+  DeadlineTimer & operator=(const DeadlineTimer &);
+  static void run(boost::asio::io_service * io_service);
+  static void fired(boost::shared_ptr<State> state, std::chrono::steady_clock::time_point deadline, const boost::system::error_code & ec);
+
+};
+
+
+#endif /* DEADLINE_TIMER_HPP_ */
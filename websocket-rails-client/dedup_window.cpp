@@ -0,0 +1,112 @@
+/**
+ *
+ * Name        : dedup_window.cpp
+ * Version     : v0.7.4
+ * Description : DedupWindow Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "dedup_window.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+DedupWindow::DedupWindow(std::size_t capacity, long max_age) : ring(capacity > 0 ? capacity : 1), head(0), count(0), max_age(max_age) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* True if the event was seen within the window, otherwise it is remembered */
+bool DedupWindow::seen(FrameEvent & event) {
+  uint64_t key = hash(event);
+  time_point now = std::chrono::steady_clock::now();
+  boost::lock_guard<boost::mutex> guard(this->dedup_mutex);
+  while(this->count > 0 && this->max_age.count() > 0 && this->ring[this->head].time + this->max_age <= now) {
+    this->evict();
+  }
+  this->stats.checked++;
+  if(this->hashes.find(key) != this->hashes.end()) {
+    this->stats.duplicates++;
+    return true;
+  }
+  if(this->count == this->ring.size()) {
+    this->evict();
+  }
+  Entry & entry = this->ring[(this->head + this->count) % this->ring.size()];
+  entry.hash = key;
+  entry.time = now;
+  this->count++;
+  this->hashes.insert(key);
+  this->stats.tracked = this->count;
+  return false;
+}
+
+
+void DedupWindow::clear() {
+  boost::lock_guard<boost::mutex> guard(this->dedup_mutex);
+  this->hashes.clear();
+  this->head = 0;
+  this->count = 0;
+  this->stats.tracked = 0;
+}
+
+
+DedupStats DedupWindow::getStats() {
+  boost::lock_guard<boost::mutex> guard(this->dedup_mutex);
+  return this->stats;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Drop the oldest entry */
+void DedupWindow::evict() {
+  this->hashes.erase(this->ring[this->head].hash);
+  this->head = (this->head + 1) % this->ring.size();
+  this->count--;
+  this->stats.tracked = this->count;
+}
+
+
+/* FNV-1a over the id, a separator telling results from events and the channel */
+uint64_t DedupWindow::hash(FrameEvent & event) {
+  StringRef id = event.getId();
+  StringRef channel = event.getChannel();
+  uint64_t h = 14695981039346656037ULL;
+  for(std::size_t i = 0; i < id.len; i++) {
+    h = (h ^ static_cast<unsigned char>(id.ptr[i])) * 1099511628211ULL;
+  }
+  h = (h ^ (event.isResult() ? 0xfe : 0xff)) * 1099511628211ULL;
+  for(std::size_t i = 0; i < channel.len; i++) {
+    h = (h ^ static_cast<unsigned char>(channel.ptr[i])) * 1099511628211ULL;
+  }
+  return h;
+}
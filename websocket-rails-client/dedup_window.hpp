@@ -0,0 +1,99 @@
+/**
+ *
+ * Name        : dedup_window.hpp
+ * Version     : v0.7.4
+ * Description : DedupWindow Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef DEDUP_WINDOW_HPP_
+#define DEDUP_WINDOW_HPP_
+
+#include "websocket.hpp"
+#include "frame_event.hpp"
+
+/**
+ *  De-duplication counters.
+ **/
+struct DedupStats {
+  DedupStats() : checked(0), duplicates(0), tracked(0) {}
+  double hitRate() const { return this->checked > 0 ? static_cast<double>(this->duplicates) / this->checked : 0; }
+  unsigned long checked;        /* Events looked up                     */
+  unsigned long duplicates;     /* Events dropped as already seen       */
+  std::size_t tracked;          /* Hashes currently in the window       */
+};
+
+/**
+ *  Remembers the 64 bit hashes of the last inbound events, bounded by
+ *  count and by age, to drop events seen before. An event is identified
+ *  by its id, its channel and whether it is a result, so results and
+ *  channel events replayed around a reconnect are recognized.
+ **/
+class DedupWindow {
+public:
+
+  /**
+   *  Type Definitions
+   **/
+  typedef std::chrono::steady_clock::time_point time_point;
+
+  /**
+   *  Constructors
+   **/
+  DedupWindow(std::size_t capacity, long max_age);
+
+  /**
+   *  Functions
+   **/
+  bool seen(FrameEvent & event);
+  void clear();
+  DedupStats getStats();
+
+private:
+
+  /**
+   *  Type Definitions
+   **/
+  struct Entry {
+    uint64_t hash;
+    time_point time;
+  };
+
+  /**
+   *  Variables
+   **/
+  std::vector<Entry> ring;                                    /* Oldest entry at head */
+  std::size_t head;
+  std::size_t count;
+  std::chrono::milliseconds max_age;                          /* 0 for no age bound   */
+  std::tr1::unordered_set<uint64_t> hashes;                   /* Hashes in the ring   */
+  DedupStats stats;
+  boost::mutex dedup_mutex;
+
+  /**
+   *  Functions
+   **/
+  void evict();
+  static uint64_t hash(FrameEvent & event);
+
+};
+
+
+#endif /* DEDUP_WINDOW_HPP_ */
@@ -0,0 +1,109 @@
+/**
+ *
+ * Name        : delivery_executor.cpp
+ * Version     : v0.7.4
+ * Description : DeliveryExecutor Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+
+
+
+#include "delivery_executor.hpp"
+
+
+
+struct DeliveryExecutor::State {
+  State() : stopped(false) {}
+  bool stopped;
+  boost::mutex mutex;
+  boost::condition_variable cond;
+  std::deque<boost::function<void()> > tasks;
+};
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+DeliveryExecutor::DeliveryExecutor() : state(boost::make_shared<State>()) {}
+
+
+/* Tasks that did not run yet are dropped */
+DeliveryExecutor::~DeliveryExecutor() {
+  {
+    boost::lock_guard<boost::mutex> guard(this->state->mutex);
+    this->state->stopped = true;
+  }
+  this->state->cond.notify_all();
+  /* The last reference can go away in a task on the delivery thread itself */
+  if(this->worker.get_id() == boost::this_thread::get_id()) {
+    this->worker.detach();
+  } else if(this->worker.joinable()) {
+    this->worker.join();
+  }
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+void DeliveryExecutor::post(boost::function<void()> task) {
+  {
+    boost::lock_guard<boost::mutex> guard(this->state->mutex);
+    if(this->state->stopped) {
+      return;
+    }
+    this->state->tasks.push_back(task);
+    if(!this->worker.joinable()) {
+      this->worker = boost::thread(&DeliveryExecutor::run, this->state);
+    }
+  }
+  this->state->cond.notify_one();
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Delivery thread, tasks run without the lock held */
+void DeliveryExecutor::run(boost::shared_ptr<State> state) {
+  boost::unique_lock<boost::mutex> lock(state->mutex);
+  while(true) {
+    while(!state->stopped && state->tasks.empty()) {
+      state->cond.wait(lock);
+    }
+    if(state->stopped) {
+      return;
+    }
+    boost::function<void()> task = state->tasks.front();
+    state->tasks.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
@@ -0,0 +1,72 @@
+/**
+ *
+ * Name        : delivery_executor.hpp
+ * Version     : v0.7.4
+ * Description : DeliveryExecutor Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+
+#ifndef DELIVERY_EXECUTOR_HPP_
+#define DELIVERY_EXECUTOR_HPP_
+
+#include "websocket.hpp"
+
+/**
+ *  One delivery thread shared by the conflated channels of a dispatcher.
+ *  Tasks run one at a time in the order they were posted; the thread is
+ *  started by the first task. A task that posts itself again goes to the
+ *  back of the queue, so channels take turns.
+ **/
+class DeliveryExecutor {
+public:
+
+  /**
+   *  Constructors
+   **/
+  DeliveryExecutor();
+  ~DeliveryExecutor();
+
+  /**
+   *  Functions
+   **/
+  void post(boost::function<void()> task);
+
+private:
+
+  struct State;
+
+  /**
+   *  Variables
+   **/
+  boost::shared_ptr<State> state;  /* Shared with the delivery thread, it may outlive the executor */
+  boost::thread worker;
+
+  /**
+   *  Functions
+   **/
+  DeliveryExecutor(const DeliveryExecutor &);
+  DeliveryExecutor & operator=(const DeliveryExecutor &);
+  static void run(boost::shared_ptr<State> state);
+
+};
+
+
+#endif /* DELIVERY_EXECUTOR_HPP_ */
@@ -0,0 +1,138 @@
+/**
+ *
+ * Name        : endpoint_set.cpp
+ * Version     : v0.7.4
+ * Description : EndpointSet Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "endpoint_set.hpp"
+#include <algorithm>
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+EndpointSet::EndpointSet() {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+void EndpointSet::add(std::string url) {
+  boost::lock_guard<boost::mutex> guard(this->endpoint_mutex);
+  if(url.empty() || this->find(url) != NULL) {
+    return;
+  }
+  EndpointStats endpoint;
+  endpoint.url = url;
+  this->endpoints.push_back(endpoint);
+}
+
+
+std::size_t EndpointSet::size() {
+  boost::lock_guard<boost::mutex> guard(this->endpoint_mutex);
+  return this->endpoints.size();
+}
+
+
+/* Urls best first */
+std::vector<std::string> EndpointSet::ranked() {
+  vec_endpoint_stats endpoints = this->getStats();
+  std::stable_sort(endpoints.begin(), endpoints.end(), &EndpointSet::ranksBefore);
+  std::vector<std::string> urls;
+  for(vec_endpoint_stats::iterator it = endpoints.begin(); it != endpoints.end(); ++it) {
+    urls.push_back(it->url);
+  }
+  return urls;
+}
+
+
+/* The endpoint won a connect race, rtt is the time from its start to client_connected */
+void EndpointSet::connected(std::string url, long rtt) {
+  this->measured(url, rtt);
+  boost::lock_guard<boost::mutex> guard(this->endpoint_mutex);
+  EndpointStats * endpoint = this->find(url);
+  if(endpoint != NULL) {
+    endpoint->connects++;
+    endpoint->failing = 0;
+  }
+}
+
+
+/* Add a round trip sample, smoothed like the TCP SRTT */
+void EndpointSet::measured(std::string url, long rtt) {
+  boost::lock_guard<boost::mutex> guard(this->endpoint_mutex);
+  EndpointStats * endpoint = this->find(url);
+  if(endpoint == NULL || rtt <= 0) {
+    return;
+  }
+  endpoint->rtt = endpoint->samples == 0 ? rtt : (7 * endpoint->rtt + rtt) / 8;
+  endpoint->samples++;
+}
+
+
+void EndpointSet::failed(std::string url) {
+  boost::lock_guard<boost::mutex> guard(this->endpoint_mutex);
+  EndpointStats * endpoint = this->find(url);
+  if(endpoint != NULL) {
+    endpoint->failures++;
+    endpoint->failing++;
+  }
+}
+
+
+vec_endpoint_stats EndpointSet::getStats() {
+  boost::lock_guard<boost::mutex> guard(this->endpoint_mutex);
+  return this->endpoints;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Called with endpoint_mutex held */
+EndpointStats * EndpointSet::find(const std::string & url) {
+  for(vec_endpoint_stats::iterator it = this->endpoints.begin(); it != this->endpoints.end(); ++it) {
+    if(it->url == url) {
+      return &*it;
+    }
+  }
+  return NULL;
+}
+
+
+bool EndpointSet::ranksBefore(const EndpointStats & a, const EndpointStats & b) {
+  if(a.failing != b.failing) {
+    return a.failing < b.failing;
+  }
+  if((a.samples > 0) != (b.samples > 0)) {
+    return a.samples > 0;
+  }
+  return a.samples > 0 && a.rtt < b.rtt;
+}
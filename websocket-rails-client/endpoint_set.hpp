@@ -0,0 +1,88 @@
+/**
+ *
+ * Name        : endpoint_set.hpp
+ * Version     : v0.7.4
+ * Description : EndpointSet Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ENDPOINT_SET_HPP_
+#define ENDPOINT_SET_HPP_
+
+#include "websocket.hpp"
+
+/**
+ *  Connection history of an endpoint, times in microseconds.
+ **/
+struct EndpointStats {
+  EndpointStats() : rtt(0), samples(0), connects(0), failures(0), failing(0) {}
+  std::string url;
+  long rtt;                     /* Smoothed round trip, 0 until measured            */
+  unsigned long samples;        /* Round trips measured                             */
+  unsigned long connects;       /* Connect races won                                */
+  unsigned long failures;       /* Failed connects and lost connections             */
+  unsigned int failing;         /* Failures since the endpoint last connected       */
+};
+
+typedef std::vector<EndpointStats> vec_endpoint_stats;
+
+/**
+ *  The endpoints of a dispatcher with their measured round trips. The
+ *  ranking puts endpoints failing fewest times in a row first, then
+ *  measured ones by smoothed round trip, then the rest in the order
+ *  they were added.
+ **/
+class EndpointSet {
+public:
+
+  /**
+   *  Constructors
+   **/
+  EndpointSet();
+
+  /**
+   *  Functions
+   **/
+  void add(std::string url);
+  std::size_t size();
+  std::vector<std::string> ranked();
+  void connected(std::string url, long rtt);
+  void measured(std::string url, long rtt);
+  void failed(std::string url);
+  vec_endpoint_stats getStats();
+
+private:
+
+  /**
+   *  Variables
+   **/
+  boost::mutex endpoint_mutex;
+  vec_endpoint_stats endpoints;
+
+  /**
+   *  Functions
+   **/
+  EndpointStats * find(const std::string & url);
+  static bool ranksBefore(const EndpointStats & a, const EndpointStats & b);
+
+};
+
+
+#endif /* ENDPOINT_SET_HPP_ */
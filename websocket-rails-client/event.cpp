@@ -23,6 +23,7 @@
  */
 
 #include "event.hpp"
+#include "string_pool.hpp"
 
 
 
@@ -30,18 +31,24 @@
  *  Constructors                    *
  ************************************/
 
-Event::Event() : success(false), result(false) {}
+EventId::EventId() : uuid(boost::uuids::nil_uuid()) {}
 
 
-Event::Event(jsonxx::Array data) : success(false), result(false) {
+Event::Event() : name(StringPool::empty()) {}
+
+
+Event::Event(jsonxx::Array data) : name(StringPool::empty()) {
   this->initObject(data);
 }
 
 
-Event::Event(jsonxx::Array data, cb_func success_callback, cb_func failure_callback) : success(false), result(false) {
-  this->success_callback = success_callback;
-  this->failure_callback = failure_callback;
-  this->initObject(data);
+PendingEvent::PendingEvent() : windowed(false) {}
+
+
+PendingEvent::PendingEvent(Event event, cb_func success_callback, cb_func failure_callback) : event(event), windowed(false) {
+  if(success_callback || failure_callback) {
+    this->callbacks = boost::make_shared<const ResultCallbacks>(std::move(success_callback), std::move(failure_callback));
+  }
 }
 
 
@@ -50,63 +57,102 @@ Event::Event(jsonxx::Array data, cb_func success_callback, cb_func failure_callb
  *  Functions                       *
  ************************************/
 
-bool Event::isChannel() {
-  return !this->channel.empty();
+EventId EventId::generate() {
+  EventId id;
+  id.uuid = boost::uuids::random_generator()();
+  return id;
+}
+
+
+/* Parse an id, ids that are no UUID are copied */
+bool EventId::parse(const char * str, std::size_t len, EventId & id) {
+  id = EventId();
+  if(len == 0) {
+    return true;
+  }
+  bool is_uuid = len == 36;
+  for(std::size_t i = 0, j = 0; is_uuid && i < len; i++) {
+    if(i == 8 || i == 13 || i == 18 || i == 23) {
+      is_uuid = str[i] == '-';
+      continue;
+    }
+    char c = str[i];
+    int nibble = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+    if(nibble < 0) {
+      is_uuid = false;
+    } else {
+      id.uuid.data[j / 2] = static_cast<boost::uuids::uuid::value_type>(j % 2 == 0 ? nibble << 4 : id.uuid.data[j / 2] | nibble);
+      j++;
+    }
+  }
+  if(is_uuid) {
+    return true;
+  }
+  id.uuid = boost::uuids::nil_uuid();
+  id.custom.assign(str, len);
+  return true;
+}
+
+
+std::string EventId::str() const {
+  if(!this->custom.empty()) {
+    return this->custom;
+  }
+  return this->uuid.is_nil() ? "" : boost::uuids::to_string(this->uuid);
 }
 
 
-bool Event::isResult() {
-  return this->result;
+std::size_t EventId::hash() const {
+  return !this->custom.empty() ? boost::hash_value(this->custom) : boost::uuids::hash_value(this->uuid);
 }
 
 
-bool Event::isPing() {
-  return this->name == "websocket_rails.ping";
+bool EventId::operator==(const EventId & other) const {
+  return this->custom == other.custom && this->uuid == other.uuid;
+}
+
+
+bool Event::isChannel() {
+  return !this->channel.empty();
 }
 
 
 std::string Event::serialize() {
   jsonxx::Array arr;
-  arr << this->name;
+  arr << *this->name;
   arr << this->attributes();
   return arr.json();
 }
 
 
-void Event::runCallbacks(bool success, jsonxx::Object event_data) {
-  if(success) {
-    if(this->success_callback) {
-      this->success_callback(event_data);
-    }
-  } else {
-    if(this->failure_callback) {
-      this->failure_callback(event_data);
-    }
-  }
-}
-
-
 /* Get the connection id */
 std::string Event::getConnectionId() {
   return this->connection_id;
 }
 
 
-/* Get the connection id */
+/* Set the connection id */
 std::string Event::setConnectionId(std::string connection_id) {
-  return this->connection_id = connection_id;
+  this->connection_id = connection_id;
+  return connection_id;
 }
 
 
 /* Get the event id */
 std::string Event::getId() {
+  return this->id.str();
+}
+
+
+/* Get the event id in binary form */
+EventId Event::getEventId() {
   return this->id;
 }
 
 
 /* Get name of event */
 std::string Event::getName() {
-  return this->name;
+  return *this->name;
 }
 
 
@@ -116,15 +162,66 @@ std::string Event::getChannel() {
 }
 
 
+/* Get channel token of event */
+std::string Event::getToken() {
+  return this->token;
+}
+
+
 /* Get data of event */
 jsonxx::Object Event::getData() {
-  return this->data;
+  return this->data ? *this->data : jsonxx::Object();
+}
+
+
+Event PendingEvent::getEvent() {
+  return this->event;
 }
 
 
-/* Get Success of event */
-bool Event::getSuccess() {
-  return this->success;
+/* Get the time after which the result is given up */
+std::chrono::steady_clock::time_point PendingEvent::getDeadline() {
+  return this->deadline;
+}
+
+
+void PendingEvent::setDeadline(std::chrono::steady_clock::time_point deadline) {
+  this->deadline = deadline;
+}
+
+
+bool PendingEvent::isWindowed() {
+  return this->windowed;
+}
+
+
+void PendingEvent::setWindowed(bool windowed) {
+  this->windowed = windowed;
+}
+
+
+/* True if a result of this outcome has a callback to go to */
+bool PendingEvent::hasCallback(bool success) {
+  if(!this->callbacks) {
+    return false;
+  }
+  return success ? !this->callbacks->success.empty() : !this->callbacks->failure.empty();
+}
+
+
+void PendingEvent::runCallbacks(bool success, jsonxx::Object event_data) {
+  if(!this->callbacks) {
+    return;
+  }
+  if(success) {
+    if(this->callbacks->success) {
+      this->callbacks->success(event_data);
+    }
+  } else {
+    if(this->callbacks->failure) {
+      this->callbacks->failure(event_data);
+    }
+  }
 }
 
 
@@ -136,22 +233,24 @@ bool Event::getSuccess() {
  ********************************************************/
 
 void Event::initObject(jsonxx::Array data) {
-  this->name = data.get<jsonxx::String>(0);
+  this->name = StringPool::intern(data.get<jsonxx::String>(0));
   if(data.has<jsonxx::Object>(1)) {
-    this->attr = data.get<jsonxx::Object>(1);
-    boost::uuids::uuid uuid = boost::uuids::random_generator()();
-    this->id = this->attr.has<jsonxx::String>("id") ? this->attr.get<jsonxx::String>("id") : boost::lexical_cast<std::string>(uuid);
-    this->channel = this->attr.has<jsonxx::String>("channel") ? this->attr.get<jsonxx::String>("channel") : "";
-    this->data = this->attr.has<jsonxx::Object>("data") ? this->attr.get<jsonxx::Object>("data") : this->attr;
-    this->token = this->attr.has<jsonxx::String>("token") ? this->attr.get<jsonxx::String>("token") : "";
-    this->server_token = this->attr.has<jsonxx::String>("server_token") ? this->attr.get<jsonxx::String>("server_token") : "";
-    this->user_id = this->attr.has<jsonxx::String>("user_id") ? this->attr.get<jsonxx::String>("user_id") : "";
-    if(this->data.has<jsonxx::String>("connection_id")) {
-      this->connection_id = this->data.get<jsonxx::String>("connection_id");
+    jsonxx::Object & attr = data.get<jsonxx::Object>(1);
+    if(attr.has<jsonxx::String>("id")) {
+      const std::string & id = attr.get<jsonxx::String>("id");
+      EventId::parse(id.data(), id.size(), this->id);
+    } else {
+      this->id = EventId::generate();
+    }
+    if(attr.has<jsonxx::String>("channel")) {
+      this->channel = attr.get<jsonxx::String>("channel");
+    }
+    if(attr.has<jsonxx::String>("token")) {
+      this->token = attr.get<jsonxx::String>("token");
     }
-    if(this->attr.has<jsonxx::Boolean>("success")) {
-      this->result = true;
-      this->success = this->attr.get<jsonxx::Boolean>("success");
+    this->data = boost::make_shared<const jsonxx::Object>(attr.has<jsonxx::Object>("data") ? attr.get<jsonxx::Object>("data") : attr);
+    if(this->data->has<jsonxx::String>("connection_id")) {
+      this->connection_id = this->data->get<jsonxx::String>("connection_id");
     }
   }
 }
@@ -159,9 +258,9 @@ void Event::initObject(jsonxx::Array data) {
 
 jsonxx::Object Event::attributes() {
   jsonxx::Object obj;
-  if(this->name != "websocket_rails.pong") { obj << "id"      << this->id;      }
-  if(!this->channel.empty())               { obj << "channel" << this->channel; }
-  if(!this->data.empty())                  { obj << "data"    << this->data;    }
-  if(!this->token.empty())                 { obj << "token"   << this->token;   }
+  if(*this->name != "websocket_rails.pong") { obj << "id"      << this->id.str(); }
+  if(!this->channel.empty())                { obj << "channel" << this->channel;  }
+  if(this->data && !this->data->empty())    { obj << "data"    << *this->data;    }
+  if(!this->token.empty())                  { obj << "token"   << this->token;    }
   return obj;
 }
@@ -26,7 +26,48 @@
 #define EVENT_HPP_
 
 #include "websocket.hpp"
+#include "callback.hpp"
 
+/**
+ *  Event id. Generated ids are UUIDs and kept in binary form, ids that are
+ *  no UUID are kept as they are.
+ **/
+class EventId {
+public:
+
+  /**
+   *  Constructors
+   **/
+  EventId();
+
+  /**
+   *  Functions
+   **/
+  static EventId generate();
+  static bool parse(const char * str, std::size_t len, EventId & id);
+  std::string str() const;
+  std::size_t hash() const;
+  bool operator==(const EventId & other) const;
+
+private:
+
+  /**
+   *  Variables
+   **/
+  boost::uuids::uuid uuid;
+  std::string custom;
+
+};
+
+struct EventIdHash {
+  std::size_t operator()(const EventId & id) const { return id.hash(); }
+};
+
+
+/**
+ *  Outbound event. The name is interned and the data is shared between
+ *  copies, so queued events stay cheap to copy.
+ **/
 class Event {
 public:
 
@@ -35,42 +76,32 @@ public:
    **/
   Event();
   Event(jsonxx::Array data);
-  Event(jsonxx::Array data, cb_func success_callback, cb_func failure_callback);
 
   /**
    *  Functions
    **/
   bool isChannel();
-  bool isResult();
-  bool isPing();
   std::string serialize();
-  void runCallbacks(bool success, jsonxx::Object result);
   std::string getConnectionId();
   std::string setConnectionId(std::string connection_id);
   std::string getId();
+  EventId getEventId();
   std::string getName();
   std::string getChannel();
+  std::string getToken();
   jsonxx::Object getData();
-  bool getSuccess();
 
 private:
 
   /**
    *  Variables
    **/
-  bool success;
-  bool result;
-  std::string id;
+  EventId id;
   std::string connection_id;
-  std::string name;
+  const std::string * name;
   std::string channel;
-  std::string token;        /* Partially used for the moment */
-  std::string server_token; /* Not used for the moment */
-  std::string user_id;      /* Not used for the moment */
-  jsonxx::Object attr;
-  jsonxx::Object data;
-  cb_func success_callback;
-  cb_func failure_callback;
+  std::string token;
+  boost::shared_ptr<const jsonxx::Object> data;
 
   /**
    *  Functions
@@ -81,4 +112,48 @@ private:
 };
 
 
+/* Success and failure callbacks of an event, shared by the copies of its PendingEvent */
+struct ResultCallbacks {
+  ResultCallbacks(cb_func success, cb_func failure) : success(std::move(success)), failure(std::move(failure)) {}
+  cb_func success;
+  cb_func failure;
+};
+
+/**
+ *  Event waiting for its result. The success and failure callbacks of an
+ *  event are only kept here.
+ **/
+class PendingEvent {
+public:
+
+  /**
+   *  Constructors
+   **/
+  PendingEvent();
+  PendingEvent(Event event, cb_func success_callback, cb_func failure_callback);
+
+  /**
+   *  Functions
+   **/
+  Event getEvent();
+  void runCallbacks(bool success, jsonxx::Object result);
+  bool hasCallback(bool success);
+  std::chrono::steady_clock::time_point getDeadline();
+  void setDeadline(std::chrono::steady_clock::time_point deadline);
+  bool isWindowed();
+  void setWindowed(bool windowed);
+
+private:
+
+  /**
+   *  Variables
+   **/
+  Event event;
+  boost::shared_ptr<const ResultCallbacks> callbacks;   /* NULL if the event has neither callback */
+  std::chrono::steady_clock::time_point deadline;   /* Epoch if the result never times out */
+  bool windowed;                                    /* Holds a slot of the in-flight window */
+
+};
+
+
 #endif /* EVENT_HPP_ */
@@ -0,0 +1,200 @@
+/**
+ *
+ * Name        : event_filter.cpp
+ * Version     : v0.7.4
+ * Description : EventFilter Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "event_filter.hpp"
+#include "frame_parser.hpp"
+#include <locale.h>
+
+/* Longest number a filter compares, longer ones do not match */
+#define FILTER_NUMBER_MAX 64
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+EventFilter::EventFilter() {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+EventFilter & EventFilter::equals(std::string field, std::string value) {
+  Condition condition;
+  condition.field = field;
+  condition.op = FILTER_STRING;
+  condition.text = value;
+  return this->add(condition);
+}
+
+
+EventFilter & EventFilter::equals(std::string field, const char * value) {
+  return this->equals(field, std::string(value));
+}
+
+
+EventFilter & EventFilter::equals(std::string field, double value) {
+  return this->between(field, value, value);
+}
+
+
+EventFilter & EventFilter::equals(std::string field, bool value) {
+  Condition condition;
+  condition.field = field;
+  condition.op = FILTER_LITERAL;
+  condition.text = value ? "true" : "false";
+  return this->add(condition);
+}
+
+
+EventFilter & EventFilter::between(std::string field, double min, double max) {
+  Condition condition;
+  condition.field = field;
+  condition.op = FILTER_RANGE;
+  condition.min = min;
+  condition.max = max;
+  return this->add(condition);
+}
+
+
+EventFilter & EventFilter::in(std::string field, std::vector<std::string> values) {
+  Condition condition;
+  condition.field = field;
+  condition.op = FILTER_STRING_SET;
+  condition.strings = boost::make_shared<const std::tr1::unordered_set<std::string> >(values.begin(), values.end());
+  return this->add(condition);
+}
+
+
+EventFilter & EventFilter::in(std::string field, std::vector<double> values) {
+  Condition condition;
+  condition.field = field;
+  condition.op = FILTER_NUMBER_SET;
+  condition.numbers = boost::make_shared<const std::set<double> >(values.begin(), values.end());
+  return this->add(condition);
+}
+
+
+/* Evaluate on the raw JSON object of the data, one pass over its members */
+bool EventFilter::matches(StringRef event_data) const {
+  if(this->conditions.empty()) {
+    return true;
+  }
+  if(event_data.empty()) {
+    return false;
+  }
+  const char * pos = event_data.ptr;
+  const char * end = event_data.ptr + event_data.len;
+  std::size_t satisfied = 0;
+  StringRef key, value;
+  while(FrameParser::nextMember(pos, end, key, value)) {
+    for(std::vector<Condition>::const_iterator it = this->conditions.begin(); it != this->conditions.end(); ++it) {
+      if(key.len != it->field.size() || std::memcmp(key.ptr, it->field.data(), key.len) != 0) {
+        continue;
+      }
+      if(!test(*it, value)) {
+        return false;
+      }
+      satisfied++;
+    }
+  }
+  return satisfied == this->conditions.size();
+}
+
+
+/* Evaluate on an already parsed object */
+bool EventFilter::matches(jsonxx::Object event_data) const {
+  std::string json = event_data.json();
+  return this->matches(StringRef(json.data(), json.size()));
+}
+
+
+bool EventFilter::empty() const {
+  return this->conditions.empty();
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+EventFilter & EventFilter::add(Condition condition) {
+  this->conditions.push_back(condition);
+  return *this;
+}
+
+
+bool EventFilter::test(const Condition & condition, StringRef value) {
+  double number;
+  switch(condition.op) {
+    case FILTER_LITERAL:
+      return value == condition.text.c_str();
+    case FILTER_RANGE:
+      return readNumber(value, number) && number >= condition.min && number <= condition.max;
+    case FILTER_NUMBER_SET:
+      return readNumber(value, number) && condition.numbers->count(number) != 0;
+    case FILTER_STRING:
+    case FILTER_STRING_SET: {
+      /* Only strings with escapes need a buffer */
+      FrameArena arena(0);
+      StringRef str;
+      if(!FrameParser::readString(value, arena, str)) {
+        return false;
+      }
+      if(condition.op == FILTER_STRING) {
+        return str.len == condition.text.size() && std::memcmp(str.ptr, condition.text.data(), str.len) == 0;
+      }
+      return condition.strings->count(str.str()) != 0;
+    }
+  }
+  return false;
+}
+
+
+/* Parse a JSON number from a copy of the span, with the C locale whatever the locale of the process */
+bool EventFilter::readNumber(StringRef value, double & number) {
+  static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", (locale_t) 0);
+  char buffer[FILTER_NUMBER_MAX + 1];
+  if(c_locale == (locale_t) 0 || value.empty() || value.len > FILTER_NUMBER_MAX || (value.ptr[0] != '-' && !std::isdigit(static_cast<unsigned char>(value.ptr[0])))) {
+    return false;
+  }
+  for(std::size_t i = 0; i < value.len; i++) {
+    char c = value.ptr[i];
+    if(!std::isdigit(static_cast<unsigned char>(c)) && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E') {
+      return false;
+    }
+    buffer[i] = c;
+  }
+  buffer[value.len] = '\0';
+  char * parsed;
+  number = strtod_l(buffer, &parsed, c_locale);
+  return parsed == buffer + value.len;
+}
@@ -0,0 +1,109 @@
+/**
+ *
+ * Name        : event_filter.hpp
+ * Version     : v0.7.4
+ * Description : EventFilter Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef EVENT_FILTER_HPP_
+#define EVENT_FILTER_HPP_
+
+#include "websocket.hpp"
+#include "binding.hpp"
+#include "frame_event.hpp"
+#include <set>
+
+/**
+ *  Declarative predicate on the top-level fields of an event's data,
+ *  all conditions must hold. It is evaluated on the raw data of the
+ *  inbound frame, so events that do not match are never parsed into a
+ *  jsonxx::Object. A missing field never matches.
+ *
+ *    EventFilter().equals("symbol", "AAPL").between("price", 100, 200)
+ **/
+class EventFilter {
+public:
+
+  /**
+   *  Constructors
+   **/
+  EventFilter();
+
+  /**
+   *  Functions
+   **/
+  EventFilter & equals(std::string field, std::string value);
+  EventFilter & equals(std::string field, const char * value);
+  EventFilter & equals(std::string field, double value);
+  EventFilter & equals(std::string field, bool value);
+  EventFilter & between(std::string field, double min, double max);
+  EventFilter & in(std::string field, std::vector<std::string> values);
+  EventFilter & in(std::string field, std::vector<double> values);
+  bool matches(StringRef event_data) const;
+  bool matches(jsonxx::Object event_data) const;
+  bool empty() const;
+
+private:
+
+  enum Operator {
+    FILTER_STRING,          /* Equal to a string                     */
+    FILTER_LITERAL,         /* Equal to true or false                */
+    FILTER_RANGE,           /* Number within [min, max]              */
+    FILTER_STRING_SET,      /* One of a set of strings               */
+    FILTER_NUMBER_SET       /* One of a set of numbers               */
+  };
+
+  struct Condition {
+    std::string field;
+    Operator op;
+    std::string text;
+    double min;
+    double max;
+    boost::shared_ptr<const std::tr1::unordered_set<std::string> > strings;
+    boost::shared_ptr<const std::set<double> > numbers;
+  };
+
+  /**
+   *  Variables
+   **/
+  std::vector<Condition> conditions;
+
+  /**
+   *  Functions
+   **/
+  EventFilter & add(Condition condition);
+  static bool test(const Condition & condition, StringRef value);
+  static bool readNumber(StringRef value, double & number);
+
+};
+
+/* A callback that only gets the events its filter matches */
+struct FilteredCallback {
+  FilteredCallback(EventFilter filter, cb_ptr callback) : filter(filter), callback(callback) {}
+  EventFilter filter;
+  cb_ptr callback;
+};
+
+typedef std::vector<FilteredCallback> vec_filtered_cb;
+typedef std::tr1::unordered_map<std::string, vec_filtered_cb> map_vec_filtered_cb;
+
+
+#endif /* EVENT_FILTER_HPP_ */
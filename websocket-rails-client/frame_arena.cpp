@@ -0,0 +1,126 @@
+/**
+ *
+ * Name        : frame_arena.cpp
+ * Version     : v0.7.4
+ * Description : FrameArena Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "frame_arena.hpp"
+#include <new>
+#include <stdint.h>
+
+/* Blocks are retained up to this multiple of the block size */
+#define FRAME_ARENA_RETAIN 16
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+FrameArena::FrameArena(std::size_t block_size) : block_size(block_size), head(NULL), cursor(NULL), limit(NULL), used(0), capacity(0) {}
+
+
+FrameArena::~FrameArena() {
+  this->release();
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+void * FrameArena::allocate(std::size_t size, std::size_t align) {
+  uintptr_t p = (reinterpret_cast<uintptr_t>(this->cursor) + align - 1) & ~(uintptr_t)(align - 1);
+  if(this->cursor == NULL || p + size > reinterpret_cast<uintptr_t>(this->limit)) {
+    this->grow(size + align);
+    p = (reinterpret_cast<uintptr_t>(this->cursor) + align - 1) & ~(uintptr_t)(align - 1);
+  }
+  this->cursor = reinterpret_cast<char *>(p + size);
+  this->used += size;
+  return reinterpret_cast<void *>(p);
+}
+
+
+/* Release all allocations of the frame, keeping the memory for the next one */
+void FrameArena::reset() {
+  if(this->block_size == 0 || this->capacity > this->block_size * FRAME_ARENA_RETAIN) {
+    this->release();
+    return;
+  }
+  if(this->head != NULL && this->head->next != NULL) {
+    /* The frame overflowed the first block, coalesce into one block of the full size */
+    std::size_t total = this->capacity;
+    this->release();
+    this->grow(total);
+  }
+  if(this->head != NULL) {
+    this->cursor = reinterpret_cast<char *>(this->head + 1);
+    this->limit = this->cursor + this->head->size;
+  }
+  this->used = 0;
+}
+
+
+std::size_t FrameArena::getUsed() {
+  return this->used;
+}
+
+
+std::size_t FrameArena::getCapacity() {
+  return this->capacity;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+void FrameArena::grow(std::size_t size) {
+  std::size_t bytes = size > this->block_size ? size : this->block_size;
+  if(bytes < this->capacity) {
+    bytes = this->capacity;
+  }
+  Block * block = static_cast<Block *>(::operator new(sizeof(Block) + bytes));
+  block->next = this->head;
+  block->size = bytes;
+  this->head = block;
+  this->cursor = reinterpret_cast<char *>(block + 1);
+  this->limit = this->cursor + bytes;
+  this->capacity += bytes;
+}
+
+
+void FrameArena::release() {
+  while(this->head != NULL) {
+    Block * next = this->head->next;
+    ::operator delete(this->head);
+    this->head = next;
+  }
+  this->cursor = NULL;
+  this->limit = NULL;
+  this->used = 0;
+  this->capacity = 0;
+}
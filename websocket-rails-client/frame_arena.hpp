@@ -0,0 +1,110 @@
+/**
+ *
+ * Name        : frame_arena.hpp
+ * Version     : v0.7.4
+ * Description : FrameArena Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef FRAME_ARENA_HPP_
+#define FRAME_ARENA_HPP_
+
+#include <cstddef>
+
+/**
+ *  Monotonic arena for the transient allocations of one inbound frame.
+ *  Allocation is a pointer bump, deallocation is a no-op and reset()
+ *  releases everything at once. Blocks are kept between frames so that a
+ *  steady stream of frames does not touch the global allocator.
+ *  Only used from the asio thread, therefore not synchronized.
+ **/
+class FrameArena {
+public:
+
+  /**
+   *  Constructors
+   **/
+  FrameArena(std::size_t block_size);
+  ~FrameArena();
+
+  /**
+   *  Functions
+   **/
+  void * allocate(std::size_t size, std::size_t align);
+  void reset();
+  std::size_t getUsed();
+  std::size_t getCapacity();
+
+private:
+
+  struct Block {
+    Block * next;
+    std::size_t size;
+  };
+
+  /**
+   *  Variables
+   **/
+  std::size_t block_size;   /* 0 disables retention of blocks between frames */
+  Block * head;
+  char * cursor;
+  char * limit;
+  std::size_t used;
+  std::size_t capacity;
+
+  /**
+   *  Functions
+   **/
+  FrameArena(const FrameArena &);
+  FrameArena & operator=(const FrameArena &);
+  void grow(std::size_t size);
+  void release();
+
+};
+
+
+/**
+ *  STL allocator on top of a FrameArena.
+ **/
+template<typename T>
+class ArenaAllocator {
+public:
+
+  typedef T value_type;
+  template<typename U> struct rebind { typedef ArenaAllocator<U> other; };
+
+  ArenaAllocator(FrameArena & arena) : arena(&arena) {}
+  template<typename U> ArenaAllocator(const ArenaAllocator<U> & other) : arena(other.arena) {}
+
+  T * allocate(std::size_t n) {
+    return static_cast<T *>(this->arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *, std::size_t) {}
+
+  template<typename U> bool operator==(const ArenaAllocator<U> & other) const { return this->arena == other.arena; }
+  template<typename U> bool operator!=(const ArenaAllocator<U> & other) const { return this->arena != other.arena; }
+
+  FrameArena * arena;
+
+};
+
+
+#endif /* FRAME_ARENA_HPP_ */
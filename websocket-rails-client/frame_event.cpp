@@ -0,0 +1,132 @@
+/**
+ *
+ * Name        : frame_event.cpp
+ * Version     : v0.7.4
+ * Description : FrameEvent Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "frame_event.hpp"
+#include "msgpack_codec.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+FrameEvent::FrameEvent() : success(false), result(false), packed(false), arena(NULL) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+bool FrameEvent::isChannel() {
+  return !this->channel.empty();
+}
+
+
+bool FrameEvent::isResult() {
+  return this->result;
+}
+
+
+bool FrameEvent::isPing() {
+  return this->name == "websocket_rails.ping";
+}
+
+
+/* Get the connection id */
+StringRef FrameEvent::getConnectionId() {
+  return this->connection_id;
+}
+
+
+/* Get the event id */
+StringRef FrameEvent::getId() {
+  return this->id;
+}
+
+
+/* Get name of event */
+StringRef FrameEvent::getName() {
+  return this->name;
+}
+
+
+/* Get channel of event */
+StringRef FrameEvent::getChannel() {
+  return this->channel;
+}
+
+
+/* Get channel token of event */
+StringRef FrameEvent::getToken() {
+  return this->token;
+}
+
+
+/* Get data of event as raw JSON, packed data is transcoded on the first call */
+StringRef FrameEvent::getRawData() {
+  if(!this->packed) {
+    return this->data;
+  }
+  if(this->json_data.empty() && !this->data.empty()) {
+    MsgpackCodec::toJson(this->data, *this->arena, this->json_data);
+  }
+  return this->json_data;
+}
+
+
+/* Get data of event, parsed into an object owned by the caller */
+jsonxx::Object FrameEvent::getData() {
+  jsonxx::Object obj;
+  if(this->packed) {
+    MsgpackCodec::unpack(this->data, obj);
+  } else if(!this->data.empty()) {
+    obj.parse(this->data.str());
+  }
+  return obj;
+}
+
+
+/* Get Success of event */
+bool FrameEvent::getSuccess() {
+  return this->success;
+}
+
+
+/* Copy the event out of the frame so that it outlives the dispatch */
+Event FrameEvent::detach() {
+  jsonxx::Array data;
+  data << this->name.str();
+  if(!this->attr.empty()) {
+    jsonxx::Object attr;
+    if(this->packed) {
+      MsgpackCodec::unpack(this->attr, attr);
+    } else {
+      attr.parse(this->attr.str());
+    }
+    data << attr;
+  }
+  return Event(data);
+}
@@ -0,0 +1,109 @@
+/**
+ *
+ * Name        : frame_event.hpp
+ * Version     : v0.7.4
+ * Description : FrameEvent Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef FRAME_EVENT_HPP_
+#define FRAME_EVENT_HPP_
+
+#include "websocket.hpp"
+#include "event.hpp"
+#include "frame_arena.hpp"
+
+/**
+ *  Non-owning reference into an inbound payload or into the frame arena.
+ **/
+struct StringRef {
+  const char * ptr;
+  std::size_t len;
+
+  StringRef() : ptr(NULL), len(0) {}
+  StringRef(const char * ptr, std::size_t len) : ptr(ptr), len(len) {}
+
+  bool empty() const { return this->len == 0; }
+  bool operator==(const char * str) const { return this->len == std::strlen(str) && std::memcmp(this->ptr, str, this->len) == 0; }
+  bool operator!=(const char * str) const { return !(*this == str); }
+  std::string str() const { return std::string(this->ptr, this->len); }
+};
+
+
+/**
+ *  Inbound event as seen while its frame is dispatched. All strings point
+ *  into the payload or the frame arena and are invalid once the frame has
+ *  been dispatched; the data payload is only parsed into a jsonxx::Object
+ *  when getData() is called. Use detach() to keep the event. Events of a
+ *  MessagePack frame keep their attributes and data packed.
+ **/
+class FrameEvent {
+public:
+
+  friend class FrameParser;
+  friend class MsgpackCodec;
+
+  /**
+   *  Constructors
+   **/
+  FrameEvent();
+
+  /**
+   *  Functions
+   **/
+  bool isChannel();
+  bool isResult();
+  bool isPing();
+  StringRef getConnectionId();
+  StringRef getId();
+  StringRef getName();
+  StringRef getChannel();
+  StringRef getToken();
+  StringRef getRawData();
+  jsonxx::Object getData();
+  bool getSuccess();
+  Event detach();
+
+private:
+
+  /**
+   *  Variables
+   **/
+  bool success;
+  bool result;
+  bool packed;              /* attr and data hold MessagePack    */
+  FrameArena * arena;       /* Holds the JSON of packed data     */
+  StringRef id;
+  StringRef connection_id;
+  StringRef name;
+  StringRef channel;
+  StringRef token;
+  StringRef server_token;   /* Not used for the moment */
+  StringRef user_id;        /* Not used for the moment */
+  StringRef attr;           /* Raw JSON of the attributes object */
+  StringRef data;           /* Raw JSON of the data object      */
+  StringRef json_data;      /* JSON of packed data, on demand   */
+
+};
+
+typedef std::vector<FrameEvent, ArenaAllocator<FrameEvent> > vec_frame_event;
+
+
+#endif /* FRAME_EVENT_HPP_ */
@@ -0,0 +1,342 @@
+/**
+ *
+ * Name        : frame_parser.cpp
+ * Version     : v0.7.4
+ * Description : FrameParser Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "frame_parser.hpp"
+
+/* Maximum nesting of arrays and objects accepted in a frame */
+#define FRAME_MAX_DEPTH 64
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Split a frame of the form [[name, attributes], ...] into its events */
+bool FrameParser::parse(const std::string & payload, FrameArena & arena, vec_frame_event & events) {
+  const char * pos = payload.data();
+  const char * end = pos + payload.size();
+  pos = skipWhitespace(pos, end);
+  if(pos == end || *pos != '[') {
+    return false;
+  }
+  pos = skipWhitespace(pos + 1, end);
+  if(pos != end && *pos == ']') {
+    return true;
+  }
+  while(pos != end) {
+    FrameEvent event;
+    if(!parseEvent(pos, end, arena, event)) {
+      return false;
+    }
+    events.push_back(event);
+    pos = skipWhitespace(pos, end);
+    if(pos == end) {
+      return false;
+    }
+    if(*pos == ']') {
+      return true;
+    }
+    if(*pos != ',') {
+      return false;
+    }
+    pos = skipWhitespace(pos + 1, end);
+  }
+  return false;
+}
+
+
+/**
+ *  Step to the next member of an object. Start with pos on the opening
+ *  brace, returns false once the closing brace is reached.
+ **/
+bool FrameParser::nextMember(const char *& pos, const char * end, StringRef & key, StringRef & value) {
+  pos = skipWhitespace(pos, end);
+  if(pos == end || (*pos != '{' && *pos != ',')) {
+    return false;
+  }
+  pos = skipWhitespace(pos + 1, end);
+  const char * start = pos;
+  if(pos == end || *pos != '"' || (pos = skipString(pos, end)) == NULL) {
+    return false;
+  }
+  key = StringRef(start + 1, pos - start - 2);
+  pos = skipWhitespace(pos, end);
+  if(pos == end || *pos != ':') {
+    return false;
+  }
+  pos = skipWhitespace(pos + 1, end);
+  start = pos;
+  if((pos = skipValue(pos, end, 0)) == NULL) {
+    return false;
+  }
+  value = StringRef(start, pos - start);
+  pos = skipWhitespace(pos, end);
+  return true;
+}
+
+
+/* Find a top-level member of a raw object */
+bool FrameParser::findMember(StringRef object, const char * key, StringRef & value) {
+  const char * pos = object.ptr;
+  const char * end = object.ptr + object.len;
+  StringRef member;
+  while(nextMember(pos, end, member, value)) {
+    if(member == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/* Read a raw string value, unescaping into the arena when necessary */
+bool FrameParser::readString(StringRef value, FrameArena & arena, StringRef & str) {
+  if(value.len < 2 || value.ptr[0] != '"') {
+    return false;
+  }
+  const char * pos = value.ptr + 1;
+  const char * end = value.ptr + value.len - 1;
+  if(std::memchr(pos, '\\', end - pos) == NULL) {
+    str = StringRef(pos, end - pos);
+    return true;
+  }
+  char * out = static_cast<char *>(arena.allocate(end - pos, 1));
+  char * start = out;
+  while(pos < end) {
+    if(*pos != '\\') {
+      *out++ = *pos++;
+      continue;
+    }
+    if(++pos == end) {
+      return false;
+    }
+    switch(*pos++) {
+      case 'b': *out++ = '\b'; break;
+      case 'f': *out++ = '\f'; break;
+      case 'n': *out++ = '\n'; break;
+      case 'r': *out++ = '\r'; break;
+      case 't': *out++ = '\t'; break;
+      case 'u': {
+        if(end - pos < 4) {
+          return false;
+        }
+        unsigned long cp = std::strtoul(std::string(pos, 4).c_str(), NULL, 16);
+        pos += 4;
+        if(cp >= 0xD800 && cp <= 0xDBFF && end - pos >= 6 && pos[0] == '\\' && pos[1] == 'u') {
+          unsigned long low = std::strtoul(std::string(pos + 2, 4).c_str(), NULL, 16);
+          if(low >= 0xDC00 && low <= 0xDFFF) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            pos += 6;
+          }
+        }
+        /* An escape sequence is never shorter than its UTF-8 encoding */
+        if(cp < 0x80) {
+          *out++ = static_cast<char>(cp);
+        } else if(cp < 0x800) {
+          *out++ = static_cast<char>(0xC0 | (cp >> 6));
+          *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        } else if(cp < 0x10000) {
+          *out++ = static_cast<char>(0xE0 | (cp >> 12));
+          *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+          *out++ = static_cast<char>(0xF0 | (cp >> 18));
+          *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+          *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        break;
+      }
+      default: *out++ = pos[-1]; break;
+    }
+  }
+  str = StringRef(start, out - start);
+  return true;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Parse one [name, attributes, ...] event, ignoring trailing elements */
+bool FrameParser::parseEvent(const char *& pos, const char * end, FrameArena & arena, FrameEvent & event) {
+  if(*pos != '[') {
+    return false;
+  }
+  pos = skipWhitespace(pos + 1, end);
+  const char * start = pos;
+  if(pos == end || *pos != '"' || (pos = skipString(pos, end)) == NULL) {
+    return false;
+  }
+  if(!readString(StringRef(start, pos - start), arena, event.name)) {
+    return false;
+  }
+  bool first = true;
+  while(true) {
+    pos = skipWhitespace(pos, end);
+    if(pos == end) {
+      return false;
+    }
+    if(*pos == ']') {
+      pos++;
+      break;
+    }
+    if(*pos != ',') {
+      return false;
+    }
+    pos = skipWhitespace(pos + 1, end);
+    start = pos;
+    if((pos = skipValue(pos, end, 1)) == NULL) {
+      return false;
+    }
+    if(first && *start == '{') {
+      event.attr = StringRef(start, pos - start);
+      parseAttributes(event, arena);
+    }
+    first = false;
+  }
+  return true;
+}
+
+
+void FrameParser::parseAttributes(FrameEvent & event, FrameArena & arena) {
+  const char * pos = event.attr.ptr;
+  const char * end = event.attr.ptr + event.attr.len;
+  StringRef key, value;
+  while(nextMember(pos, end, key, value)) {
+    if(key == "id") {
+      readString(value, arena, event.id);
+    } else if(key == "channel") {
+      readString(value, arena, event.channel);
+    } else if(key == "data") {
+      if(value.ptr[0] == '{') {
+        event.data = value;
+      }
+    } else if(key == "token") {
+      readString(value, arena, event.token);
+    } else if(key == "server_token") {
+      readString(value, arena, event.server_token);
+    } else if(key == "user_id") {
+      readString(value, arena, event.user_id);
+    } else if(key == "success") {
+      if(value == "true" || value == "false") {
+        event.result = true;
+        event.success = value == "true";
+      }
+    }
+  }
+  if(event.data.empty()) {
+    event.data = event.attr;
+  }
+  if(findMember(event.data, "connection_id", value)) {
+    readString(value, arena, event.connection_id);
+  }
+}
+
+
+const char * FrameParser::skipWhitespace(const char * pos, const char * end) {
+  while(pos != end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+    pos++;
+  }
+  return pos;
+}
+
+
+const char * FrameParser::skipString(const char * pos, const char * end) {
+  for(pos++; pos < end; pos++) {
+    if(*pos == '"') {
+      return pos + 1;
+    }
+    if(*pos == '\\') {
+      pos++;
+    }
+  }
+  return NULL;
+}
+
+
+/* Skip over a JSON value, returns NULL if it is malformed */
+const char * FrameParser::skipValue(const char * pos, const char * end, int depth) {
+  if(pos == end || depth > FRAME_MAX_DEPTH) {
+    return NULL;
+  }
+  switch(*pos) {
+    case '"':
+      return skipString(pos, end);
+    case '{':
+    case '[': {
+      char close = *pos == '{' ? '}' : ']';
+      pos = skipWhitespace(pos + 1, end);
+      if(pos != end && *pos == close) {
+        return pos + 1;
+      }
+      while(pos != end) {
+        if(close == '}') {
+          if(*pos != '"' || (pos = skipString(pos, end)) == NULL) {
+            return NULL;
+          }
+          pos = skipWhitespace(pos, end);
+          if(pos == end || *pos != ':') {
+            return NULL;
+          }
+          pos = skipWhitespace(pos + 1, end);
+        }
+        if((pos = skipValue(pos, end, depth + 1)) == NULL) {
+          return NULL;
+        }
+        pos = skipWhitespace(pos, end);
+        if(pos == end) {
+          return NULL;
+        }
+        if(*pos == close) {
+          return pos + 1;
+        }
+        if(*pos != ',') {
+          return NULL;
+        }
+        pos = skipWhitespace(pos + 1, end);
+      }
+      return NULL;
+    }
+    case 't':
+      return end - pos >= 4 && std::memcmp(pos, "true", 4) == 0 ? pos + 4 : NULL;
+    case 'f':
+      return end - pos >= 5 && std::memcmp(pos, "false", 5) == 0 ? pos + 5 : NULL;
+    case 'n':
+      return end - pos >= 4 && std::memcmp(pos, "null", 4) == 0 ? pos + 4 : NULL;
+    default: {
+      const char * start = pos;
+      while(pos != end && (std::isdigit(static_cast<unsigned char>(*pos)) || *pos == '-' || *pos == '+' || *pos == '.' || *pos == 'e' || *pos == 'E')) {
+        pos++;
+      }
+      return pos != start ? pos : NULL;
+    }
+  }
+}
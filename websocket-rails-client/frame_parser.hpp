@@ -0,0 +1,63 @@
+/**
+ *
+ * Name        : frame_parser.hpp
+ * Version     : v0.7.4
+ * Description : FrameParser Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef FRAME_PARSER_HPP_
+#define FRAME_PARSER_HPP_
+
+#include "websocket.hpp"
+#include "frame_arena.hpp"
+#include "frame_event.hpp"
+
+/**
+ *  Scanner for inbound Websocket-Rails frames. It splits a frame into its
+ *  events and picks out the attributes needed for routing without building
+ *  a JSON tree; unescaped strings are placed in the frame arena.
+ **/
+class FrameParser {
+public:
+
+  /**
+   *  Functions
+   **/
+  static bool parse(const std::string & payload, FrameArena & arena, vec_frame_event & events);
+  static bool nextMember(const char *& pos, const char * end, StringRef & key, StringRef & value);
+  static bool findMember(StringRef object, const char * key, StringRef & value);
+  static bool readString(StringRef value, FrameArena & arena, StringRef & str);
+
+private:
+
+  /**
+   *  Functions
+   **/
+  static bool parseEvent(const char *& pos, const char * end, FrameArena & arena, FrameEvent & event);
+  static void parseAttributes(FrameEvent & event, FrameArena & arena);
+  static const char * skipWhitespace(const char * pos, const char * end);
+  static const char * skipString(const char * pos, const char * end);
+  static const char * skipValue(const char * pos, const char * end, int depth);
+
+};
+
+
+#endif /* FRAME_PARSER_HPP_ */
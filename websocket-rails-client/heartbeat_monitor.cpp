@@ -0,0 +1,156 @@
+/**
+ *
+ * Name        : heartbeat_monitor.cpp
+ * Version     : v0.7.4
+ * Description : HeartbeatMonitor Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "heartbeat_monitor.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+HeartbeatMonitor::HeartbeatMonitor(HeartbeatPolicy policy) : policy(policy), started(false), pinged(false), probing(false), learned_interval(0), rtt_total(0) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* The connection is open, deadlines count from now */
+void HeartbeatMonitor::start(time_point now) {
+  boost::lock_guard<boost::mutex> guard(this->monitor_mutex);
+  this->started = true;
+  this->last_activity = now;
+}
+
+
+/* An inbound frame arrived */
+void HeartbeatMonitor::activity(time_point now) {
+  boost::lock_guard<boost::mutex> guard(this->monitor_mutex);
+  this->last_activity = now;
+  this->stats.missed = 0;
+}
+
+
+/* A server ping arrived, its interval becomes the deadline period unless one is configured */
+void HeartbeatMonitor::ping(time_point now) {
+  boost::lock_guard<boost::mutex> guard(this->monitor_mutex);
+  if(this->pinged) {
+    this->learned_interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - this->last_ping).count();
+  }
+  this->pinged = true;
+  this->last_ping = now;
+  this->last_activity = now;
+  this->stats.missed = 0;
+}
+
+
+/* The pong of a probe arrived */
+void HeartbeatMonitor::pong(time_point now) {
+  boost::lock_guard<boost::mutex> guard(this->monitor_mutex);
+  this->last_activity = now;
+  this->stats.missed = 0;
+  if(!this->probing) {
+    return;
+  }
+  this->probing = false;
+  long rtt = std::chrono::duration_cast<std::chrono::microseconds>(now - this->probe_sent).count();
+  this->rtt_total += rtt;
+  this->stats.pongs++;
+  this->stats.rtt_last = rtt;
+  this->stats.rtt_min = this->stats.pongs == 1 || rtt < this->stats.rtt_min ? rtt : this->stats.rtt_min;
+  this->stats.rtt_max = rtt > this->stats.rtt_max ? rtt : this->stats.rtt_max;
+  this->stats.rtt_avg = this->rtt_total / static_cast<long>(this->stats.pongs);
+}
+
+
+/* True if a probe is due: a probe interval without inbound traffic, or the last probe went unanswered as long */
+bool HeartbeatMonitor::probe(time_point now) {
+  boost::lock_guard<boost::mutex> guard(this->monitor_mutex);
+  if(!this->started || this->stats.dead || this->policy.probe_interval <= 0) {
+    return false;
+  }
+  std::chrono::milliseconds interval(this->policy.probe_interval);
+  if(now - this->last_activity < interval || (this->probing && now - this->probe_sent < interval)) {
+    return false;
+  }
+  this->probing = true;
+  this->probe_sent = now;
+  this->stats.probes++;
+  return true;
+}
+
+
+/* Count the deadlines missed up to now, true once max_missed of them in a row make the connection dead */
+bool HeartbeatMonitor::expired(time_point now) {
+  boost::lock_guard<boost::mutex> guard(this->monitor_mutex);
+  long period = this->period();
+  if(!this->started || this->stats.dead || period <= 0 || this->policy.max_missed == 0) {
+    return false;
+  }
+  unsigned int missed = static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(now - this->last_activity).count() / period);
+  if(missed > this->stats.missed) {
+    this->stats.missed_total += missed - this->stats.missed;
+    this->stats.missed = missed;
+  }
+  this->stats.dead = this->stats.missed >= this->policy.max_missed;
+  return this->stats.dead;
+}
+
+
+bool HeartbeatMonitor::isDead() {
+  boost::lock_guard<boost::mutex> guard(this->monitor_mutex);
+  return this->stats.dead;
+}
+
+
+LivenessStats HeartbeatMonitor::getStats() {
+  boost::lock_guard<boost::mutex> guard(this->monitor_mutex);
+  LivenessStats stats = this->stats;
+  stats.period = this->period() * 1000;
+  stats.silence = this->started ? std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->last_activity).count() : 0;
+  return stats;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Deadline period in milliseconds, called with monitor_mutex held */
+long HeartbeatMonitor::period() {
+  if(this->policy.ping_interval > 0) {
+    return this->policy.ping_interval;
+  }
+  if(this->policy.probe_interval > 0) {
+    /* The silence before a probe and as long again for its pong */
+    return 2 * this->policy.probe_interval;
+  }
+  return this->learned_interval;
+}
@@ -0,0 +1,119 @@
+/**
+ *
+ * Name        : heartbeat_monitor.hpp
+ * Version     : v0.7.4
+ * Description : HeartbeatMonitor Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef HEARTBEAT_MONITOR_HPP_
+#define HEARTBEAT_MONITOR_HPP_
+
+#include "websocket.hpp"
+
+/**
+ *  When a connection counts as dead, times in milliseconds.
+ **/
+struct HeartbeatPolicy {
+  HeartbeatPolicy() : ping_interval(0), probe_interval(0), max_missed(HEARTBEAT_MAX_MISSED) {}
+  long ping_interval;           /* Expected time between server pings, 0 learns it from the pings seen       */
+  long probe_interval;          /* Send a websocket ping after this long without inbound traffic, 0 for none */
+  unsigned int max_missed;      /* Missed deadlines before the connection is dead, 0 turns the monitor off  */
+};
+
+/**
+ *  Liveness counters of a connection, times in microseconds.
+ **/
+struct LivenessStats {
+  LivenessStats() : period(0), silence(0), missed(0), missed_total(0), probes(0), pongs(0), rtt_last(0), rtt_min(0), rtt_max(0), rtt_avg(0), dead(false) {}
+  long period;                  /* Deadline period in use, 0 while there is none            */
+  long silence;                 /* Time since the last inbound frame                        */
+  unsigned int missed;          /* Deadlines missed in a row                                */
+  unsigned long missed_total;   /* Deadlines missed over the life of the connection         */
+  unsigned long probes;         /* Websocket pings sent                                     */
+  unsigned long pongs;          /* Websocket pongs received                                 */
+  long rtt_last;                /* Round trip of the last answered probe                    */
+  long rtt_min;
+  long rtt_max;
+  long rtt_avg;
+  bool dead;                    /* The connection was declared dead                         */
+};
+
+/**
+ *  Deadline based liveness of a connection, fed by the IO thread. Every
+ *  inbound frame resets the silence; each deadline period without one is
+ *  a missed deadline, and max_missed in a row make the connection dead.
+ *  The period is the configured server ping interval, else twice the
+ *  probe interval when probing, else the server ping interval seen last.
+ *  Probes keep a quiet but healthy connection talking and measure the
+ *  round trip, so a half-open TCP connection is found within
+ *  max_missed periods instead of the minutes the OS takes.
+ **/
+class HeartbeatMonitor {
+public:
+
+  /**
+   *  Type Definitions
+   **/
+  typedef std::chrono::steady_clock::time_point time_point;
+
+  /**
+   *  Constructors
+   **/
+  HeartbeatMonitor(HeartbeatPolicy policy);
+
+  /**
+   *  Functions
+   **/
+  void start(time_point now);
+  void activity(time_point now);
+  void ping(time_point now);
+  void pong(time_point now);
+  bool probe(time_point now);
+  bool expired(time_point now);
+  bool isDead();
+  LivenessStats getStats();
+
+private:
+
+  /**
+   *  Variables
+   **/
+  boost::mutex monitor_mutex;
+  HeartbeatPolicy policy;
+  time_point last_activity;
+  time_point last_ping;
+  time_point probe_sent;
+  bool started;
+  bool pinged;
+  bool probing;                 /* A probe waits for its pong */
+  long learned_interval;        /* Milliseconds between the last two server pings */
+  long rtt_total;
+  LivenessStats stats;
+
+  /**
+   *  Functions
+   **/
+  long period();
+
+};
+
+
+#endif /* HEARTBEAT_MONITOR_HPP_ */
@@ -0,0 +1,302 @@
+/**
+ *
+ * Name        : in_flight_window.cpp
+ * Version     : v0.7.4
+ * Description : InFlightWindow Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "in_flight_window.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+InFlightWindow::InFlightWindow() : policy(WINDOW_BLOCK), limit(0), block_timeout(WINDOW_BLOCK_TIMEOUT), next_ticket(1) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Set the global limit, 0 for no limit */
+void InFlightWindow::setLimit(std::size_t limit) {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  this->limit = limit;
+}
+
+
+/* Set the limit of one event name, 0 for no limit */
+void InFlightWindow::setLimit(std::string event_name, std::size_t limit) {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  if(limit == 0) {
+    this->limits.erase(event_name);
+  } else {
+    this->limits[event_name] = limit;
+  }
+}
+
+
+void InFlightWindow::setPolicy(WindowPolicy policy) {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  this->policy = policy;
+}
+
+
+/* Longest wait of a blocked trigger in milliseconds, an earlier deadline of the event wins */
+void InFlightWindow::setBlockTimeout(long timeout) {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  this->block_timeout = timeout;
+}
+
+
+WindowPolicy InFlightWindow::getPolicy() {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  return this->policy;
+}
+
+
+/* Take a slot for the event, or wait, queue or reject it according to the policy */
+WindowResult InFlightWindow::acquire(PendingEvent pending, bool may_block) {
+  std::string event_name = pending.getEvent().getName();
+  boost::unique_lock<boost::mutex> lock(this->window_mutex);
+  if(this->fits(event_name) && !this->isWaiting(event_name)) {
+    this->take(event_name);
+    return WINDOW_ACQUIRED;
+  }
+  if(this->policy == WINDOW_FAIL) {
+    this->stats.rejected++;
+    return WINDOW_REJECTED;
+  }
+  if(this->policy == WINDOW_QUEUE || !may_block) {
+    this->enqueue(this->waiting.end(), event_name, pending, 0);
+    this->stats.deferred++;
+    return WINDOW_DEFERRED;
+  }
+  /* Wait in line, admit() takes the slot for us and grants the ticket */
+  std::size_t ticket = this->next_ticket++;
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(this->block_timeout);
+  if(pending.getDeadline() != std::chrono::steady_clock::time_point() && pending.getDeadline() < deadline) {
+    deadline = pending.getDeadline();
+  }
+  this->enqueue(this->waiting.end(), event_name, pending, ticket);
+  this->stats.blocked++;
+  while(this->granted.erase(ticket) == 0) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(now >= deadline) {
+      for(std::deque<Waiter>::iterator it = this->waiting.begin(); it != this->waiting.end(); ++it) {
+        if(it->ticket == ticket) {
+          this->dequeue(it);
+          break;
+        }
+      }
+      this->stats.timed_out++;
+      return WINDOW_FULL;
+    }
+    this->window_cond.wait_for(lock, boost::chrono::milliseconds(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1));
+  }
+  return WINDOW_ACQUIRED;
+}
+
+
+/* Give a slot back, returns the queued events that got a slot in turn */
+std::vector<PendingEvent> InFlightWindow::release(std::string event_name) {
+  std::vector<PendingEvent> admitted;
+  {
+    boost::lock_guard<boost::mutex> guard(this->window_mutex);
+    std::tr1::unordered_map<std::string, std::size_t>::iterator found = this->in_flight.find(event_name);
+    if(found != this->in_flight.end() && --found->second == 0) {
+      this->in_flight.erase(found);
+    }
+    this->stats.in_flight--;
+    admitted = this->admit();
+  }
+  this->window_cond.notify_all();
+  return admitted;
+}
+
+
+/* Remove the queued events whose deadline has passed */
+std::vector<PendingEvent> InFlightWindow::takeExpired(std::chrono::steady_clock::time_point now) {
+  std::vector<PendingEvent> expired;
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  for(std::deque<Waiter>::iterator it = this->waiting.begin(); it != this->waiting.end();) {
+    std::chrono::steady_clock::time_point deadline = it->pending.getDeadline();
+    if(it->ticket == 0 && deadline != std::chrono::steady_clock::time_point() && deadline <= now) {
+      expired.push_back(it->pending);
+      it = this->dequeue(it);
+    } else {
+      ++it;
+    }
+  }
+  return expired;
+}
+
+
+/* Earliest deadline of the queued events, the epoch if none has one */
+std::chrono::steady_clock::time_point InFlightWindow::nextDeadline() {
+  std::chrono::steady_clock::time_point next;
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  for(std::deque<Waiter>::iterator it = this->waiting.begin(); it != this->waiting.end(); ++it) {
+    std::chrono::steady_clock::time_point deadline = it->pending.getDeadline();
+    if(it->ticket == 0 && deadline != std::chrono::steady_clock::time_point() && (next == std::chrono::steady_clock::time_point() || deadline < next)) {
+      next = deadline;
+    }
+  }
+  return next;
+}
+
+
+/* Take a queued event back out, e.g. when it is cancelled before it was sent */
+bool InFlightWindow::withdraw(EventId id, PendingEvent & pending) {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  for(std::deque<Waiter>::iterator it = this->waiting.begin(); it != this->waiting.end(); ++it) {
+    if(it->ticket == 0 && it->pending.getEvent().getEventId() == id) {
+      pending = it->pending;
+      this->dequeue(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/* Take all queued events back out, oldest first; blocked triggers keep waiting */
+std::vector<PendingEvent> InFlightWindow::takeWaiting() {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  std::vector<PendingEvent> waiting;
+  for(std::deque<Waiter>::iterator it = this->waiting.begin(); it != this->waiting.end();) {
+    if(it->ticket == 0) {
+      waiting.push_back(it->pending);
+      it = this->dequeue(it);
+    } else {
+      ++it;
+    }
+  }
+  return waiting;
+}
+
+
+/* Put events taken with takeWaiting back ahead of the ones queued since, returns those that got a slot meanwhile */
+std::vector<PendingEvent> InFlightWindow::restoreWaiting(std::vector<PendingEvent> pending) {
+  std::vector<PendingEvent> admitted;
+  {
+    boost::lock_guard<boost::mutex> guard(this->window_mutex);
+    for(std::vector<PendingEvent>::reverse_iterator it = pending.rbegin(); it != pending.rend(); ++it) {
+      this->enqueue(this->waiting.begin(), it->getEvent().getName(), *it, 0);
+    }
+    admitted = this->admit();
+  }
+  this->window_cond.notify_all();
+  return admitted;
+}
+
+
+WindowStats InFlightWindow::getStats() {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  return this->stats;
+}
+
+
+/* Number of events of a name waiting for their result */
+std::size_t InFlightWindow::getInFlight(std::string event_name) {
+  boost::lock_guard<boost::mutex> guard(this->window_mutex);
+  std::tr1::unordered_map<std::string, std::size_t>::iterator found = this->in_flight.find(event_name);
+  return found != this->in_flight.end() ? found->second : 0;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+bool InFlightWindow::fits(const std::string & event_name) {
+  if(this->limit != 0 && this->stats.in_flight >= this->limit) {
+    return false;
+  }
+  std::tr1::unordered_map<std::string, std::size_t>::iterator max = this->limits.find(event_name);
+  if(max == this->limits.end()) {
+    return true;
+  }
+  std::tr1::unordered_map<std::string, std::size_t>::iterator used = this->in_flight.find(event_name);
+  return used == this->in_flight.end() || used->second < max->second;
+}
+
+
+/* Events of the same name keep their order */
+bool InFlightWindow::isWaiting(const std::string & event_name) {
+  return this->waiters.find(event_name) != this->waiters.end();
+}
+
+
+/* Give free slots to the waiting events in order, returns the admitted queued ones; blocked triggers get their ticket granted */
+std::vector<PendingEvent> InFlightWindow::admit() {
+  std::vector<PendingEvent> admitted;
+  for(std::deque<Waiter>::iterator it = this->waiting.begin(); it != this->waiting.end();) {
+    if(this->fits(it->event_name)) {
+      this->take(it->event_name);
+      if(it->ticket != 0) {
+        this->granted.insert(it->ticket);
+      } else {
+        admitted.push_back(it->pending);
+      }
+      it = this->dequeue(it);
+    } else if(this->limit != 0 && this->stats.in_flight >= this->limit) {
+      break;
+    } else {
+      ++it;
+    }
+  }
+  return admitted;
+}
+
+
+void InFlightWindow::take(const std::string & event_name) {
+  this->in_flight[event_name]++;
+  this->stats.in_flight++;
+  this->stats.acquired++;
+  if(this->stats.in_flight > this->stats.peak) {
+    this->stats.peak = this->stats.in_flight;
+  }
+}
+
+
+void InFlightWindow::enqueue(std::deque<Waiter>::iterator pos, const std::string & event_name, PendingEvent pending, std::size_t ticket) {
+  this->waiting.insert(pos, Waiter(event_name, pending, ticket));
+  this->waiters[event_name]++;
+  this->stats.waiting = this->waiting.size();
+}
+
+
+std::deque<InFlightWindow::Waiter>::iterator InFlightWindow::dequeue(std::deque<Waiter>::iterator it) {
+  std::tr1::unordered_map<std::string, std::size_t>::iterator found = this->waiters.find(it->event_name);
+  if(found != this->waiters.end() && --found->second == 0) {
+    this->waiters.erase(found);
+  }
+  it = this->waiting.erase(it);
+  this->stats.waiting = this->waiting.size();
+  return it;
+}
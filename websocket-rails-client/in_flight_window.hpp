@@ -0,0 +1,133 @@
+/**
+ *
+ * Name        : in_flight_window.hpp
+ * Version     : v0.7.4
+ * Description : InFlightWindow Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef IN_FLIGHT_WINDOW_HPP_
+#define IN_FLIGHT_WINDOW_HPP_
+
+#include "websocket.hpp"
+#include "event.hpp"
+
+/* What a trigger does when the window is full */
+enum WindowPolicy {
+  WINDOW_BLOCK,     /* Wait for a free slot, in turn (queued instead on the asio thread)   */
+  WINDOW_FAIL,      /* Fail the event at once with {"error": "window_full"}                  */
+  WINDOW_QUEUE      /* Keep the event and send it when a slot frees up                       */
+};
+
+enum WindowResult {
+  WINDOW_ACQUIRED,
+  WINDOW_REJECTED,
+  WINDOW_DEFERRED,
+  WINDOW_FULL       /* Blocked until the wait timed out */
+};
+
+/**
+ *  Window occupancy metrics.
+ **/
+struct WindowStats {
+  WindowStats() : in_flight(0), peak(0), waiting(0), acquired(0), rejected(0), deferred(0), blocked(0), timed_out(0) {}
+  std::size_t in_flight;        /* Correlated events waiting for their result */
+  std::size_t peak;
+  std::size_t waiting;          /* Events queued or blocked for a slot        */
+  unsigned long acquired;
+  unsigned long rejected;
+  unsigned long deferred;
+  unsigned long blocked;        /* Triggers that had to wait for a slot       */
+  unsigned long timed_out;      /* Blocked triggers that gave up              */
+};
+
+/**
+ *  Limits the number of correlated events in flight, globally and per
+ *  event name. A slot is taken when the event is sent and given back when
+ *  its result arrives, it times out or it is cancelled. Queued events and
+ *  blocked triggers wait in one line, so events of a name get their
+ *  slots in the order they were triggered.
+ **/
+class InFlightWindow {
+public:
+
+  /**
+   *  Constructors
+   **/
+  InFlightWindow();
+
+  /**
+   *  Functions
+   **/
+  void setLimit(std::size_t limit);
+  void setLimit(std::string event_name, std::size_t limit);
+  void setPolicy(WindowPolicy policy);
+  void setBlockTimeout(long timeout);
+  WindowPolicy getPolicy();
+  WindowResult acquire(PendingEvent pending, bool may_block);
+  std::vector<PendingEvent> release(std::string event_name);
+  std::vector<PendingEvent> takeExpired(std::chrono::steady_clock::time_point now);
+  std::chrono::steady_clock::time_point nextDeadline();
+  bool withdraw(EventId id, PendingEvent & pending);
+  std::vector<PendingEvent> takeWaiting();
+  std::vector<PendingEvent> restoreWaiting(std::vector<PendingEvent> pending);
+  WindowStats getStats();
+  std::size_t getInFlight(std::string event_name);
+
+private:
+
+  /* A queued event, or the event of a blocked trigger (ticket is not 0) */
+  struct Waiter {
+    Waiter(std::string event_name, PendingEvent pending, std::size_t ticket) : event_name(event_name), pending(pending), ticket(ticket) {}
+    std::string event_name;
+    PendingEvent pending;
+    std::size_t ticket;
+  };
+
+  /**
+   *  Variables
+   **/
+  WindowPolicy policy;
+  std::size_t limit;                                            /* 0 for no limit */
+  long block_timeout;                                           /* Milliseconds   */
+  std::tr1::unordered_map<std::string, std::size_t> limits;     /* Map<key,value>: Event Name, Limit     */
+  std::tr1::unordered_map<std::string, std::size_t> in_flight;  /* Map<key,value>: Event Name, In Flight */
+  std::tr1::unordered_map<std::string, std::size_t> waiters;    /* Map<key,value>: Event Name, Waiting   */
+  std::deque<Waiter> waiting;
+  std::tr1::unordered_set<std::size_t> granted;                 /* Tickets of blocked triggers that got a slot */
+  std::size_t next_ticket;
+  WindowStats stats;
+  boost::mutex window_mutex;
+  boost::condition_variable window_cond;
+
+  /**
+   *  Functions
+   **/
+  bool fits(const std::string & event_name);
+  bool isWaiting(const std::string & event_name);
+  void take(const std::string & event_name);
+  void enqueue(std::deque<Waiter>::iterator pos, const std::string & event_name, PendingEvent pending, std::size_t ticket);
+  std::deque<Waiter>::iterator dequeue(std::deque<Waiter>::iterator it);
+  std::vector<PendingEvent> admit();
+
+};
+
+
+#endif /* IN_FLIGHT_WINDOW_HPP_ */
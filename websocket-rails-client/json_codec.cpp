@@ -0,0 +1,76 @@
+/**
+ *
+ * Name        : json_codec.cpp
+ * Version     : v0.7.4
+ * Description : JsonCodec Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "json_codec.hpp"
+#include "frame_parser.hpp"
+
+
+/* A frame holding nothing but a server ping, its attributes have no arrays */
+const std::string JsonCodec::ping_prefix = "[[\"websocket_rails.ping\",";
+
+/* The serialized websocket_rails.pong event, it carries neither id nor data */
+const std::string JsonCodec::pong_frame = "[\"websocket_rails.pong\",{}]";
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+WireFormat JsonCodec::getFormat() {
+  return WIRE_JSON;
+}
+
+
+std::string JsonCodec::getSubprotocol() {
+  return "";
+}
+
+
+websocketpp::frame::opcode::value JsonCodec::getOpcode() {
+  return websocketpp::frame::opcode::text;
+}
+
+
+std::string JsonCodec::encode(Event event) {
+  return event.serialize();
+}
+
+
+bool JsonCodec::decode(const std::string & payload, FrameArena & arena, vec_frame_event & events) {
+  return FrameParser::parse(payload, arena, events);
+}
+
+
+bool JsonCodec::isPing(const std::string & payload) {
+  std::size_t len = payload.size();
+  return len > ping_prefix.size() + 2 && payload.compare(0, ping_prefix.size(), ping_prefix) == 0 &&
+         payload[len - 1] == ']' && payload[len - 2] == ']' && std::memchr(payload.data(), ']', len - 2) == NULL;
+}
+
+
+const std::string & JsonCodec::getPongFrame() {
+  return pong_frame;
+}
@@ -0,0 +1,57 @@
+/**
+ *
+ * Name        : json_codec.hpp
+ * Version     : v0.7.4
+ * Description : JsonCodec Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef JSON_CODEC_HPP_
+#define JSON_CODEC_HPP_
+
+#include "wire_codec.hpp"
+
+/**
+ *  The Websocket-Rails JSON text protocol.
+ **/
+class JsonCodec : public WireCodec {
+public:
+
+  /**
+   *  Variables
+   **/
+  static const std::string ping_prefix;
+  static const std::string pong_frame;
+
+  /**
+   *  Functions
+   **/
+  WireFormat getFormat();
+  std::string getSubprotocol();
+  websocketpp::frame::opcode::value getOpcode();
+  std::string encode(Event event);
+  bool decode(const std::string & payload, FrameArena & arena, vec_frame_event & events);
+  bool isPing(const std::string & payload);
+  const std::string & getPongFrame();
+
+};
+
+
+#endif /* JSON_CODEC_HPP_ */
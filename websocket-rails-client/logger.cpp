@@ -0,0 +1,207 @@
+/**
+ *
+ * Name        : logger.cpp
+ * Version     : v0.7.4
+ * Description : Logger Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "logger.hpp"
+#include <iostream>
+#include <cstdio>
+
+std::atomic<int> Logger::runtime_level(LOG_INFO);
+std::atomic<unsigned long> Logger::dropped(0);
+std::atomic<std::size_t> Logger::enqueue_pos(0);
+std::atomic<std::size_t> Logger::dequeue_pos(0);
+Logger::Cell * Logger::ring = NULL;
+boost::once_flag Logger::start_flag = BOOST_ONCE_INIT;
+boost::mutex Logger::sink_mutex;
+log_sink_func Logger::sink;
+
+static boost::thread log_thread;
+static std::atomic<bool> log_running(false);
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Set the lowest level that is logged at runtime */
+void Logger::setLevel(LogLevel level) {
+  runtime_level.store(level, std::memory_order_relaxed);
+}
+
+
+LogLevel Logger::getLevel() {
+  return static_cast<LogLevel>(runtime_level.load(std::memory_order_relaxed));
+}
+
+
+/* Replace the sink, it is called on the log thread only */
+void Logger::setSink(log_sink_func sink) {
+  boost::lock_guard<boost::mutex> guard(sink_mutex);
+  Logger::sink = sink;
+}
+
+
+void Logger::write(LogLevel level, const std::string & message) {
+  LogRecord record;
+  record.level = level;
+  record.code = 0;
+  record.length = message.size() < LOG_RECORD_TEXT ? message.size() : LOG_RECORD_TEXT;
+  std::memcpy(record.text, message.data(), record.length);
+  push(record);
+}
+
+
+void Logger::write(LogLevel level, unsigned int code, long long a0, long long a1, long long a2, long long a3) {
+  LogRecord record;
+  record.level = level;
+  record.code = code;
+  record.length = 0;
+  record.args[0] = a0;
+  record.args[1] = a1;
+  record.args[2] = a2;
+  record.args[3] = a3;
+  push(record);
+}
+
+
+/* Wait until the log thread has written all records pushed so far */
+void Logger::flush() {
+  std::size_t target = enqueue_pos.load(std::memory_order_acquire);
+  while(log_running.load() && dequeue_pos.load(std::memory_order_acquire) < target) {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+  }
+}
+
+
+/* Number of records lost because the ring was full */
+unsigned long Logger::getDropped() {
+  return dropped.load(std::memory_order_relaxed);
+}
+
+
+std::string Logger::format(const LogRecord & record) {
+  static const char * levels[] = { "trace", "debug", "info", "warn", "error", "none" };
+  char head[64];
+  std::snprintf(head, sizeof(head), "[%lld.%06lld] [%s] ", record.timestamp / 1000000, record.timestamp % 1000000, levels[record.level]);
+  std::string line(head);
+  if(record.code == 0) {
+    line.append(record.text, record.length);
+  } else {
+    char body[128];
+    std::snprintf(body, sizeof(body), "record %u: %lld %lld %lld %lld", record.code, record.args[0], record.args[1], record.args[2], record.args[3]);
+    line.append(body);
+  }
+  return line;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+void Logger::start() {
+  ring = new Cell[LOG_RING_SIZE];
+  for(std::size_t i = 0; i < LOG_RING_SIZE; i++) {
+    ring[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  if(!sink) {
+    sink = &Logger::defaultSink;
+  }
+  log_running.store(true);
+  log_thread = boost::thread(&Logger::run);
+  std::atexit(&Logger::stop);
+}
+
+
+/* Drain what is left and stop the log thread at exit */
+void Logger::stop() {
+  flush();
+  log_running.store(false);
+  log_thread.join();
+}
+
+
+void Logger::run() {
+  LogRecord record;
+  while(log_running.load()) {
+    if(!pop(record)) {
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+      continue;
+    }
+    boost::lock_guard<boost::mutex> guard(sink_mutex);
+    if(sink) {
+      sink(record);
+    }
+  }
+}
+
+
+/* Bounded multi-producer ring, a slot is free when its sequence equals the position */
+bool Logger::push(LogRecord & record) {
+  boost::call_once(start_flag, &Logger::start);
+  record.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+  Cell * cell;
+  while(true) {
+    cell = &ring[pos & (LOG_RING_SIZE - 1)];
+    std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+    long diff = static_cast<long>(seq) - static_cast<long>(pos);
+    if(diff == 0) {
+      if(enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if(diff < 0) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+  cell->record = record;
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+
+/* Single consumer, only called from the log thread */
+bool Logger::pop(LogRecord & record) {
+  std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+  Cell * cell = &ring[pos & (LOG_RING_SIZE - 1)];
+  if(cell->sequence.load(std::memory_order_acquire) != pos + 1) {
+    return false;
+  }
+  record = cell->record;
+  cell->sequence.store(pos + LOG_RING_SIZE, std::memory_order_release);
+  dequeue_pos.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+
+void Logger::defaultSink(const LogRecord & record) {
+  std::clog << format(record) << std::endl;
+}
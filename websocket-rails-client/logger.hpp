@@ -0,0 +1,129 @@
+/**
+ *
+ * Name        : logger.hpp
+ * Version     : v0.7.4
+ * Description : Logger Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef LOGGER_HPP_
+#define LOGGER_HPP_
+
+#include "websocket.hpp"
+#include <atomic>
+
+#define LOG_RING_SIZE 4096      /* Records buffered for the log thread, power of two */
+#define LOG_RECORD_TEXT 232     /* Text bytes per record, longer messages are cut    */
+#define LOG_RECORD_ARGS 4       /* Arguments of a binary record                      */
+
+enum LogLevel {
+  LOG_TRACE = 0,
+  LOG_DEBUG = 1,
+  LOG_INFO  = 2,
+  LOG_WARN  = 3,
+  LOG_ERROR = 4,
+  LOG_NONE  = 5
+};
+
+/* Records below this level are compiled out */
+#ifndef WSR_LOG_LEVEL
+#define WSR_LOG_LEVEL LOG_TRACE
+#endif
+
+/* True when records of the level are compiled in and enabled at runtime */
+#define WSR_LOG_ENABLED(level) ((level) >= WSR_LOG_LEVEL && Logger::isEnabled(level))
+
+/* Log a text message, the message expression is only evaluated when the level is enabled */
+#define WSR_LOG(level, message) \
+  do { if(WSR_LOG_ENABLED(level)) { Logger::write((level), (message)); } } while(0)
+
+/* Log a binary record of a code and up to four integer arguments, nothing is formatted on the caller */
+#define WSR_LOG_RECORD(level, code, a0, a1, a2, a3) \
+  do { if(WSR_LOG_ENABLED(level)) { Logger::write((level), (code), (a0), (a1), (a2), (a3)); } } while(0)
+
+/**
+ *  Log record as passed from the producers to the log thread.
+ *  Text records have code 0, binary records carry a code and arguments.
+ **/
+struct LogRecord {
+  LogLevel level;
+  unsigned int code;
+  long long timestamp;          /* Microseconds since the epoch */
+  long long args[LOG_RECORD_ARGS];
+  std::size_t length;
+  char text[LOG_RECORD_TEXT];
+};
+
+typedef boost::function<void(const LogRecord &)> log_sink_func;
+
+/**
+ *  Asynchronous logger. Producers copy a record into a lock-free ring and
+ *  return, a background thread drains the ring into the sink. When the
+ *  ring is full records are dropped and counted rather than blocking.
+ **/
+class Logger {
+public:
+
+  /**
+   *  Functions
+   **/
+  static bool isEnabled(LogLevel level) { return level >= runtime_level.load(std::memory_order_relaxed); }
+  static void setLevel(LogLevel level);
+  static LogLevel getLevel();
+  static void setSink(log_sink_func sink);
+  static void write(LogLevel level, const std::string & message);
+  static void write(LogLevel level, unsigned int code, long long a0, long long a1, long long a2, long long a3);
+  static void flush();
+  static unsigned long getDropped();
+  static std::string format(const LogRecord & record);
+
+private:
+
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    LogRecord record;
+  };
+
+  /**
+   *  Variables
+   **/
+  static std::atomic<int> runtime_level;
+  static std::atomic<unsigned long> dropped;
+  static std::atomic<std::size_t> enqueue_pos;
+  static std::atomic<std::size_t> dequeue_pos;
+  static Cell * ring;
+  static boost::once_flag start_flag;
+  static boost::mutex sink_mutex;
+  static log_sink_func sink;
+
+  /**
+   *  Functions
+   **/
+  static void start();
+  static void stop();
+  static void run();
+  static bool push(LogRecord & record);
+  static bool pop(LogRecord & record);
+  static void defaultSink(const LogRecord & record);
+
+};
+
+
+#endif /* LOGGER_HPP_ */
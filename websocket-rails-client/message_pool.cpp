@@ -0,0 +1,120 @@
+/**
+ *
+ * Name        : message_pool.cpp
+ * Version     : v0.7.4
+ * Description : MessagePool Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "message_pool.hpp"
+
+/* The pool new websocketpp connections on the current thread take their buffers from */
+static thread_local MessagePool * installed_pool = NULL;
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+MessagePool::MessagePool() {
+  for(std::size_t i = 0; i < MESSAGE_POOL_CLASSES; i++) {
+    this->classes[i].reserve(MESSAGE_POOL_DEPTH);
+  }
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Hand an empty buffer with room for size bytes to buffer, from the smallest size class that has one */
+void MessagePool::acquire(std::string & buffer, std::size_t size) {
+  std::size_t size_class = 0;
+  while(size_class < MESSAGE_POOL_CLASSES && classSize(size_class) < size) {
+    size_class++;
+  }
+  boost::lock_guard<boost::mutex> guard(this->pool_mutex);
+  for(std::size_t i = size_class; i < MESSAGE_POOL_CLASSES; i++) {
+    if(!this->classes[i].empty()) {
+      buffer.swap(this->classes[i].back());
+      this->classes[i].pop_back();
+      this->stats.hits++;
+      this->stats.pooled--;
+      this->stats.pooled_bytes -= buffer.capacity();
+      return;
+    }
+  }
+  this->stats.misses++;
+  /* Allocate the full class so the buffer comes back into it */
+  buffer.reserve(size_class < MESSAGE_POOL_CLASSES ? classSize(size_class) : size);
+}
+
+
+/* Take the capacity of buffer back into the pool, buffer is left empty */
+void MessagePool::release(std::string & buffer) {
+  std::size_t capacity = buffer.capacity();
+  boost::lock_guard<boost::mutex> guard(this->pool_mutex);
+  if(capacity < classSize(0) || capacity >= 2 * classSize(MESSAGE_POOL_CLASSES - 1)) {
+    this->stats.dropped++;
+    return;
+  }
+  std::size_t size_class = MESSAGE_POOL_CLASSES - 1;
+  while(classSize(size_class) > capacity) {
+    size_class--;
+  }
+  std::vector<std::string> & free_buffers = this->classes[size_class];
+  if(free_buffers.size() >= MESSAGE_POOL_DEPTH) {
+    this->stats.dropped++;
+    return;
+  }
+  buffer.clear();
+  free_buffers.push_back(std::string());
+  free_buffers.back().swap(buffer);
+  this->stats.recycled++;
+  this->stats.pooled++;
+  this->stats.pooled_bytes += capacity;
+}
+
+
+MessagePoolStats MessagePool::getStats() {
+  boost::lock_guard<boost::mutex> guard(this->pool_mutex);
+  return this->stats;
+}
+
+
+std::size_t MessagePool::classSize(std::size_t size_class) {
+  return static_cast<std::size_t>(MESSAGE_POOL_MIN) << (2 * size_class);
+}
+
+
+/* Make pool the one of connections created on this thread, NULL to reset; returns the one installed before */
+MessagePool * MessagePool::install(MessagePool * pool) {
+  MessagePool * previous = installed_pool;
+  installed_pool = pool;
+  return previous;
+}
+
+
+/* The pool installed on this thread, a pool of its own if there is none */
+boost::shared_ptr<MessagePool> MessagePool::installed() {
+  return installed_pool != NULL ? installed_pool->shared_from_this() : boost::make_shared<MessagePool>();
+}
@@ -0,0 +1,88 @@
+/**
+ *
+ * Name        : message_pool.hpp
+ * Version     : v0.7.4
+ * Description : MessagePool Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef MESSAGE_POOL_HPP_
+#define MESSAGE_POOL_HPP_
+
+#include "websocket.hpp"
+#include <boost/enable_shared_from_this.hpp>
+
+/**
+ *  Message pool counters.
+ **/
+struct MessagePoolStats {
+  MessagePoolStats() : hits(0), misses(0), recycled(0), dropped(0), pooled(0), pooled_bytes(0) {}
+  double hitRate() const { return this->hits + this->misses > 0 ? static_cast<double>(this->hits) / (this->hits + this->misses) : 0; }
+  unsigned long hits;           /* Buffers taken from the pool                            */
+  unsigned long misses;         /* Buffers allocated because the size class was empty     */
+  unsigned long recycled;       /* Buffers given back to the pool                         */
+  unsigned long dropped;        /* Buffers freed: size out of range or size class full    */
+  std::size_t pooled;           /* Buffers in the pool now                                */
+  std::size_t pooled_bytes;     /* Capacity held by them                                  */
+};
+
+/**
+ *  Payload buffers of websocket frames, kept for reuse in size classes
+ *  of MESSAGE_POOL_MIN bytes times powers of four. A buffer goes back
+ *  cleared but with its capacity, at most MESSAGE_POOL_DEPTH per class;
+ *  buffers too small or too large for the classes are freed.
+ **/
+class MessagePool : public boost::enable_shared_from_this<MessagePool> {
+public:
+
+  /**
+   *  Constructors
+   **/
+  MessagePool();
+
+  /**
+   *  Functions
+   **/
+  void acquire(std::string & buffer, std::size_t size);
+  void release(std::string & buffer);
+  MessagePoolStats getStats();
+  static std::size_t classSize(std::size_t size_class);
+  static MessagePool * install(MessagePool * pool);
+  static boost::shared_ptr<MessagePool> installed();
+
+private:
+
+  /**
+   *  Variables
+   **/
+  boost::mutex pool_mutex;
+  std::vector<std::string> classes[MESSAGE_POOL_CLASSES];   /* Free buffers by size class */
+  MessagePoolStats stats;
+
+  /**
+   *  Functions
+   **/
+  MessagePool(const MessagePool &);
+  MessagePool & operator=(const MessagePool &);
+
+};
+
+
+#endif /* MESSAGE_POOL_HPP_ */
@@ -0,0 +1,676 @@
+/**
+ *
+ * Name        : msgpack_codec.cpp
+ * Version     : v0.7.4
+ * Description : MsgpackCodec Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "msgpack_codec.hpp"
+#include <cstdio>
+#include <cmath>
+#include <cinttypes>
+#include <locale.h>
+
+#define MSGPACK_MAX_DEPTH 64
+
+
+const std::string MsgpackCodec::subprotocol = "websocket_rails.msgpack";
+
+/* fixarray(1), fixarray(2), fixstr(20) "websocket_rails.ping" */
+const std::string MsgpackCodec::ping_prefix = std::string("\x91\x92\xb4") + "websocket_rails.ping";
+
+/* fixarray(2), fixstr(20) "websocket_rails.pong", fixmap(0) */
+const std::string MsgpackCodec::pong_frame = std::string("\x92\xb4") + "websocket_rails.pong" + std::string("\x80", 1);
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+WireFormat MsgpackCodec::getFormat() {
+  return WIRE_MSGPACK;
+}
+
+
+std::string MsgpackCodec::getSubprotocol() {
+  return subprotocol;
+}
+
+
+websocketpp::frame::opcode::value MsgpackCodec::getOpcode() {
+  return websocketpp::frame::opcode::binary;
+}
+
+
+/* [name, {id, channel, data, token}], the same attributes as Event::serialize() */
+std::string MsgpackCodec::encode(Event event) {
+  std::string out;
+  std::string name = event.getName();
+  std::string channel = event.getChannel();
+  std::string token = event.getToken();
+  jsonxx::Object data = event.getData();
+  bool has_id = name != "websocket_rails.pong";
+  std::size_t members = (has_id ? 1 : 0) + (channel.empty() ? 0 : 1) + (data.empty() ? 0 : 1) + (token.empty() ? 0 : 1);
+  out += '\x92';
+  pack(name, out);
+  packHeader(0x80, 15, 0xde, members, out);
+  if(has_id)          { pack(std::string("id"), out);      pack(event.getId(), out); }
+  if(!channel.empty()) { pack(std::string("channel"), out); pack(channel, out);        }
+  if(!data.empty())    { pack(std::string("data"), out);    pack(data, out);           }
+  if(!token.empty())   { pack(std::string("token"), out);   pack(token, out);          }
+  return out;
+}
+
+
+/* Split a frame of the form [[name, attributes], ...] into its events, without copying */
+bool MsgpackCodec::decode(const std::string & payload, FrameArena & arena, vec_frame_event & events) {
+  const unsigned char * pos = reinterpret_cast<const unsigned char *>(payload.data());
+  const unsigned char * end = pos + payload.size();
+  Item frame;
+  if(!readItem(pos, end, frame) || frame.type != ITEM_ARRAY) {
+    return false;
+  }
+  for(std::size_t i = 0; i < frame.size; i++) {
+    FrameEvent event;
+    if(!scanEvent(pos, end, arena, event)) {
+      return false;
+    }
+    events.push_back(event);
+  }
+  return pos == end;
+}
+
+
+bool MsgpackCodec::isPing(const std::string & payload) {
+  return payload.size() > ping_prefix.size() && payload.compare(0, ping_prefix.size(), ping_prefix) == 0;
+}
+
+
+const std::string & MsgpackCodec::getPongFrame() {
+  return pong_frame;
+}
+
+
+/* Transcode a MessagePack value into JSON text */
+bool MsgpackCodec::toJson(const std::string & payload, std::string & json) {
+  const unsigned char * pos = reinterpret_cast<const unsigned char *>(payload.data());
+  const unsigned char * end = pos + payload.size();
+  json.reserve(json.size() + payload.size() + payload.size() / 4);
+  return transcode(pos, end, json, 0) && pos == end;
+}
+
+
+/* Transcode a packed value into JSON text held by the arena */
+bool MsgpackCodec::toJson(StringRef packed, FrameArena & arena, StringRef & json) {
+  const unsigned char * pos = reinterpret_cast<const unsigned char *>(packed.ptr);
+  const unsigned char * end = pos + packed.len;
+  std::string text;
+  if(!transcode(pos, end, text, 0) || pos != end) {
+    return false;
+  }
+  char * out = static_cast<char *>(arena.allocate(text.size(), 1));
+  std::memcpy(out, text.data(), text.size());
+  json = StringRef(out, text.size());
+  return true;
+}
+
+
+/* Unpack a packed map straight into an object, integers and floats keep their exact value */
+bool MsgpackCodec::unpack(StringRef packed, jsonxx::Object & object) {
+  const unsigned char * pos = reinterpret_cast<const unsigned char *>(packed.ptr);
+  const unsigned char * end = pos + packed.len;
+  Item map;
+  if(!readItem(pos, end, map) || map.type != ITEM_MAP) {
+    return false;
+  }
+  return unpackMap(pos, end, map.size, object, 1);
+}
+
+
+/* Find a top-level member of a packed map */
+bool MsgpackCodec::findMember(StringRef map, const char * key, StringRef & value) {
+  const unsigned char * pos = reinterpret_cast<const unsigned char *>(map.ptr);
+  const unsigned char * end = pos + map.len;
+  Item item;
+  if(!readItem(pos, end, item) || item.type != ITEM_MAP) {
+    return false;
+  }
+  for(std::size_t i = 0; i < item.size; i++) {
+    Item name;
+    if(!readItem(pos, end, name)) {
+      return false;
+    }
+    const unsigned char * start = pos;
+    if(!skip(pos, end, 1)) {
+      return false;
+    }
+    if(name.type == ITEM_STR && name.str == key) {
+      value = StringRef(reinterpret_cast<const char *>(start), pos - start);
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/* Transcode a JSON frame into MessagePack */
+bool MsgpackCodec::fromJson(const std::string & json, std::string & payload) {
+  jsonxx::Array frame;
+  if(!frame.parse(json)) {
+    return false;
+  }
+  pack(frame, payload);
+  return true;
+}
+
+
+void MsgpackCodec::pack(const jsonxx::Value & value, std::string & out) {
+  if(value.is<jsonxx::String>()) {
+    pack(value.get<jsonxx::String>(), out);
+  } else if(value.is<jsonxx::Number>()) {
+    packNumber(value.get<jsonxx::Number>(), out);
+  } else if(value.is<jsonxx::Boolean>()) {
+    out += value.get<jsonxx::Boolean>() ? '\xc3' : '\xc2';
+  } else if(value.is<jsonxx::Object>()) {
+    pack(value.get<jsonxx::Object>(), out);
+  } else if(value.is<jsonxx::Array>()) {
+    pack(value.get<jsonxx::Array>(), out);
+  } else {
+    out += '\xc0';
+  }
+}
+
+
+void MsgpackCodec::pack(const jsonxx::Object & object, std::string & out) {
+  const jsonxx::Object::container & members = object.kv_map();
+  packHeader(0x80, 15, 0xde, members.size(), out);
+  for(jsonxx::Object::container::const_iterator it = members.begin(); it != members.end(); ++it) {
+    pack(it->first, out);
+    pack(*it->second, out);
+  }
+}
+
+
+void MsgpackCodec::pack(const jsonxx::Array & array, std::string & out) {
+  const jsonxx::Array::container & values = array.values();
+  packHeader(0x90, 15, 0xdc, values.size(), out);
+  for(jsonxx::Array::container::const_iterator it = values.begin(); it != values.end(); ++it) {
+    pack(**it, out);
+  }
+}
+
+
+void MsgpackCodec::pack(const std::string & str, std::string & out) {
+  std::size_t len = str.size();
+  if(len < 32) {
+    out += static_cast<char>(0xa0 | len);
+  } else if(len <= 0xff) {
+    out += '\xd9';
+    packBig(len, 1, out);
+  } else if(len <= 0xffff) {
+    out += '\xda';
+    packBig(len, 2, out);
+  } else {
+    out += '\xdb';
+    packBig(len, 4, out);
+  }
+  out += str;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+/* Header of an array or map: fix format, 16 or 32 bit size */
+void MsgpackCodec::packHeader(unsigned char fix, unsigned char fix_max, unsigned char code16, std::size_t size, std::string & out) {
+  if(size <= fix_max) {
+    out += static_cast<char>(fix | size);
+  } else if(size <= 0xffff) {
+    out += static_cast<char>(code16);
+    packBig(size, 2, out);
+  } else {
+    out += static_cast<char>(code16 + 1);
+    packBig(size, 4, out);
+  }
+}
+
+
+/* Integral numbers take the smallest integer format, all others a float 64 */
+void MsgpackCodec::packNumber(jsonxx::Number number, std::string & out) {
+  if(number == std::floor(number) && number >= -9223372036854775807.0L && number <= 18446744073709551615.0L) {
+    if(number >= 0) {
+      uint64_t value = static_cast<uint64_t>(number);
+      if(value < 0x80)             { out += static_cast<char>(value); }
+      else if(value <= 0xff)       { out += '\xcc'; packBig(value, 1, out); }
+      else if(value <= 0xffff)     { out += '\xcd'; packBig(value, 2, out); }
+      else if(value <= 0xffffffff) { out += '\xce'; packBig(value, 4, out); }
+      else                         { out += '\xcf'; packBig(value, 8, out); }
+    } else {
+      int64_t value = static_cast<int64_t>(number);
+      if(value >= -32)             { out += static_cast<char>(value); }
+      else if(value >= -128)       { out += '\xd0'; packBig(static_cast<uint64_t>(value), 1, out); }
+      else if(value >= -32768)     { out += '\xd1'; packBig(static_cast<uint64_t>(value), 2, out); }
+      else if(value >= -2147483647L - 1) { out += '\xd2'; packBig(static_cast<uint64_t>(value), 4, out); }
+      else                         { out += '\xd3'; packBig(static_cast<uint64_t>(value), 8, out); }
+    }
+    return;
+  }
+  double value = static_cast<double>(number);
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  out += '\xcb';
+  packBig(bits, 8, out);
+}
+
+
+void MsgpackCodec::packBig(uint64_t value, int bytes, std::string & out) {
+  for(int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+    out += static_cast<char>((value >> shift) & 0xff);
+  }
+}
+
+
+uint64_t MsgpackCodec::readBig(const unsigned char *& pos, int bytes) {
+  uint64_t value = 0;
+  for(int i = 0; i < bytes; i++) {
+    value = (value << 8) | *pos++;
+  }
+  return value;
+}
+
+
+/* Read the header of the next value, and the whole value if it is a string */
+bool MsgpackCodec::readItem(const unsigned char *& pos, const unsigned char * end, Item & item) {
+  if(pos == end) {
+    return false;
+  }
+  unsigned char code = *pos++;
+  int width = 0;
+  if(code <= 0x7f) {
+    item.type = ITEM_UINT;
+    item.uint = code;
+    return true;
+  } else if(code >= 0xe0) {
+    item.type = ITEM_INT;
+    item.sint = static_cast<signed char>(code);
+    return true;
+  } else if((code & 0xf0) == 0x80) {
+    item.type = ITEM_MAP;
+    item.size = code & 0x0f;
+    return true;
+  } else if((code & 0xf0) == 0x90) {
+    item.type = ITEM_ARRAY;
+    item.size = code & 0x0f;
+    return true;
+  } else if((code & 0xe0) == 0xa0) {
+    item.type = ITEM_STR;
+    item.size = code & 0x1f;
+  } else {
+    switch(code) {
+      case 0xc0: item.type = ITEM_NIL; return true;
+      case 0xc2: case 0xc3: item.type = ITEM_BOOL; item.boolean = code == 0xc3; return true;
+      case 0xc4: case 0xd9: item.type = ITEM_STR; width = 1; break;
+      case 0xc5: case 0xda: item.type = ITEM_STR; width = 2; break;
+      case 0xc6: case 0xdb: item.type = ITEM_STR; width = 4; break;
+      case 0xdc: item.type = ITEM_ARRAY; width = 2; break;
+      case 0xdd: item.type = ITEM_ARRAY; width = 4; break;
+      case 0xde: item.type = ITEM_MAP; width = 2; break;
+      case 0xdf: item.type = ITEM_MAP; width = 4; break;
+      case 0xcc: case 0xcd: case 0xce: case 0xcf: {
+        width = 1 << (code - 0xcc);
+        if(end - pos < width) {
+          return false;
+        }
+        item.type = ITEM_UINT;
+        item.uint = readBig(pos, width);
+        return true;
+      }
+      case 0xd0: case 0xd1: case 0xd2: case 0xd3: {
+        width = 1 << (code - 0xd0);
+        if(end - pos < width) {
+          return false;
+        }
+        uint64_t bits = readBig(pos, width);
+        int shift = 64 - width * 8;
+        item.type = ITEM_INT;
+        item.sint = shift > 0 ? static_cast<int64_t>(bits << shift) >> shift : static_cast<int64_t>(bits);
+        return true;
+      }
+      case 0xca: {
+        if(end - pos < 4) {
+          return false;
+        }
+        uint32_t bits = static_cast<uint32_t>(readBig(pos, 4));
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        item.type = ITEM_FLOAT32;
+        item.real = value;
+        return true;
+      }
+      case 0xcb: {
+        if(end - pos < 8) {
+          return false;
+        }
+        uint64_t bits = readBig(pos, 8);
+        item.type = ITEM_FLOAT64;
+        std::memcpy(&item.real, &bits, sizeof(item.real));
+        return true;
+      }
+      default:
+        /* Extension types are not part of the protocol */
+        return false;
+    }
+    if(end - pos < width) {
+      return false;
+    }
+    item.size = static_cast<std::size_t>(readBig(pos, width));
+  }
+  if(item.type != ITEM_STR) {
+    return true;
+  }
+  if(static_cast<std::size_t>(end - pos) < item.size) {
+    return false;
+  }
+  item.str = StringRef(reinterpret_cast<const char *>(pos), item.size);
+  pos += item.size;
+  return true;
+}
+
+
+/* Skip over a value, returns false if it is malformed */
+bool MsgpackCodec::skip(const unsigned char *& pos, const unsigned char * end, int depth) {
+  Item item;
+  if(depth > MSGPACK_MAX_DEPTH || !readItem(pos, end, item)) {
+    return false;
+  }
+  uint64_t elements = item.type == ITEM_MAP ? static_cast<uint64_t>(item.size) * 2 : item.type == ITEM_ARRAY ? item.size : 0;
+  for(uint64_t i = 0; i < elements; i++) {
+    if(!skip(pos, end, depth + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/* Scan one [name, attributes, ...] event, ignoring trailing elements */
+bool MsgpackCodec::scanEvent(const unsigned char *& pos, const unsigned char * end, FrameArena & arena, FrameEvent & event) {
+  Item item, name;
+  if(!readItem(pos, end, item) || item.type != ITEM_ARRAY || item.size == 0) {
+    return false;
+  }
+  if(!readItem(pos, end, name) || name.type != ITEM_STR) {
+    return false;
+  }
+  event.name = name.str;
+  event.packed = true;
+  event.arena = &arena;
+  for(std::size_t i = 1; i < item.size; i++) {
+    const unsigned char * start = pos;
+    if(!skip(pos, end, 1)) {
+      return false;
+    }
+    if(i == 1 && isMap(*start)) {
+      event.attr = StringRef(reinterpret_cast<const char *>(start), pos - start);
+      scanAttributes(event);
+    }
+  }
+  return true;
+}
+
+
+/* The attributes have been checked by skip() already */
+void MsgpackCodec::scanAttributes(FrameEvent & event) {
+  const unsigned char * pos = reinterpret_cast<const unsigned char *>(event.attr.ptr);
+  const unsigned char * end = pos + event.attr.len;
+  Item map, key;
+  readItem(pos, end, map);
+  for(std::size_t i = 0; i < map.size && readItem(pos, end, key); i++) {
+    const unsigned char * value = pos;
+    if(!skip(pos, end, 1)) {
+      return;
+    }
+    if(key.type != ITEM_STR) {
+      continue;
+    }
+    if(key.str == "id") {
+      readString(value, pos, event.id);
+    } else if(key.str == "channel") {
+      readString(value, pos, event.channel);
+    } else if(key.str == "data") {
+      if(isMap(*value)) {
+        event.data = StringRef(reinterpret_cast<const char *>(value), pos - value);
+      }
+    } else if(key.str == "token") {
+      readString(value, pos, event.token);
+    } else if(key.str == "server_token") {
+      readString(value, pos, event.server_token);
+    } else if(key.str == "user_id") {
+      readString(value, pos, event.user_id);
+    } else if(key.str == "success") {
+      if(*value == 0xc2 || *value == 0xc3) {
+        event.result = true;
+        event.success = *value == 0xc3;
+      }
+    }
+  }
+  if(event.data.empty()) {
+    event.data = event.attr;
+  }
+  StringRef connection_id;
+  if(findMember(event.data, "connection_id", connection_id)) {
+    const unsigned char * start = reinterpret_cast<const unsigned char *>(connection_id.ptr);
+    readString(start, start + connection_id.len, event.connection_id);
+  }
+}
+
+
+bool MsgpackCodec::readString(const unsigned char * pos, const unsigned char * end, StringRef & str) {
+  Item item;
+  if(!readItem(pos, end, item) || item.type != ITEM_STR) {
+    return false;
+  }
+  str = item.str;
+  return true;
+}
+
+
+bool MsgpackCodec::isMap(unsigned char code) {
+  return (code & 0xf0) == 0x80 || code == 0xde || code == 0xdf;
+}
+
+
+/* JSON keys are strings, integer keys are taken in their decimal form */
+bool MsgpackCodec::unpackMap(const unsigned char *& pos, const unsigned char * end, std::size_t size, jsonxx::Object & object, int depth) {
+  if(depth > MSGPACK_MAX_DEPTH) {
+    return false;
+  }
+  for(std::size_t i = 0; i < size; i++) {
+    Item key, item;
+    if(!readItem(pos, end, key) || !readItem(pos, end, item)) {
+      return false;
+    }
+    std::string name;
+    if(key.type == ITEM_STR) {
+      name = key.str.str();
+    } else if(key.type == ITEM_UINT) {
+      name = boost::lexical_cast<std::string>(key.uint);
+    } else if(key.type == ITEM_INT) {
+      name = boost::lexical_cast<std::string>(key.sint);
+    } else {
+      return false;
+    }
+    if(item.type == ITEM_MAP) {
+      jsonxx::Object member;
+      if(!unpackMap(pos, end, item.size, member, depth + 1)) {
+        return false;
+      }
+      object.import(name, member);
+    } else if(item.type == ITEM_ARRAY) {
+      jsonxx::Array member;
+      if(!unpackArray(pos, end, item.size, member, depth + 1)) {
+        return false;
+      }
+      object.import(name, member);
+    } else {
+      object.import(name, toValue(item));
+    }
+  }
+  return true;
+}
+
+
+bool MsgpackCodec::unpackArray(const unsigned char *& pos, const unsigned char * end, std::size_t size, jsonxx::Array & array, int depth) {
+  if(depth > MSGPACK_MAX_DEPTH) {
+    return false;
+  }
+  for(std::size_t i = 0; i < size; i++) {
+    Item item;
+    if(!readItem(pos, end, item)) {
+      return false;
+    }
+    if(item.type == ITEM_MAP) {
+      jsonxx::Object member;
+      if(!unpackMap(pos, end, item.size, member, depth + 1)) {
+        return false;
+      }
+      array.append(jsonxx::Value(member));
+    } else if(item.type == ITEM_ARRAY) {
+      jsonxx::Array member;
+      if(!unpackArray(pos, end, item.size, member, depth + 1)) {
+        return false;
+      }
+      array.append(jsonxx::Value(member));
+    } else {
+      array.append(toValue(item));
+    }
+  }
+  return true;
+}
+
+
+/* A scalar as jsonxx value, a float 32 is widened exactly */
+jsonxx::Value MsgpackCodec::toValue(const Item & item) {
+  switch(item.type) {
+    case ITEM_BOOL:    return jsonxx::Value(item.boolean);
+    case ITEM_UINT:    return jsonxx::Value(static_cast<jsonxx::Number>(item.uint));
+    case ITEM_INT:     return jsonxx::Value(static_cast<jsonxx::Number>(item.sint));
+    case ITEM_FLOAT32:
+    case ITEM_FLOAT64: return jsonxx::Value(static_cast<jsonxx::Number>(item.real));
+    case ITEM_STR:     return jsonxx::Value(item.str.str());
+    default:           return jsonxx::Value(jsonxx::Null());
+  }
+}
+
+
+/* A float 32 is written with the digits that give back the same float. Numbers are formatted in the C locale,
+   whatever the locale of the process, as the filters parse them */
+bool MsgpackCodec::transcode(const unsigned char *& pos, const unsigned char * end, std::string & json, int depth) {
+  static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", (locale_t) 0);
+  Item item;
+  char number[32];
+  if(depth > MSGPACK_MAX_DEPTH || !readItem(pos, end, item)) {
+    return false;
+  }
+  switch(item.type) {
+    case ITEM_NIL:  json += "null"; return true;
+    case ITEM_BOOL: json += item.boolean ? "true" : "false"; return true;
+    case ITEM_UINT:
+      std::snprintf(number, sizeof(number), "%" PRIu64, item.uint);
+      json += number;
+      return true;
+    case ITEM_INT:
+      std::snprintf(number, sizeof(number), "%" PRId64, item.sint);
+      json += number;
+      return true;
+    case ITEM_FLOAT32:
+    case ITEM_FLOAT64:
+      if(c_locale != (locale_t) 0 && std::isfinite(item.real)) {
+        locale_t previous = uselocale(c_locale);
+        std::snprintf(number, sizeof(number), item.type == ITEM_FLOAT32 ? "%.9g" : "%.17g", item.real);
+        uselocale(previous);
+        json += number;
+      } else {
+        json += "null";
+      }
+      return true;
+    case ITEM_STR:
+      quote(item.str.ptr, item.str.len, json);
+      return true;
+    default:
+      break;
+  }
+  bool is_map = item.type == ITEM_MAP;
+  json += is_map ? '{' : '[';
+  for(std::size_t i = 0; i < item.size; i++) {
+    if(i > 0) {
+      json += ',';
+    }
+    if(is_map) {
+      /* JSON keys are strings, other keys are quoted in their JSON form */
+      const unsigned char * start = pos;
+      Item key;
+      if(!readItem(pos, end, key)) {
+        return false;
+      }
+      if(key.type == ITEM_STR) {
+        quote(key.str.ptr, key.str.len, json);
+      } else {
+        std::string text;
+        pos = start;
+        if(!transcode(pos, end, text, depth + 1)) {
+          return false;
+        }
+        quote(text.data(), text.size(), json);
+      }
+      json += ':';
+    }
+    if(!transcode(pos, end, json, depth + 1)) {
+      return false;
+    }
+  }
+  json += is_map ? '}' : ']';
+  return true;
+}
+
+
+void MsgpackCodec::quote(const char * str, std::size_t len, std::string & json) {
+  json += '"';
+  for(std::size_t i = 0; i < len; i++) {
+    unsigned char c = static_cast<unsigned char>(str[i]);
+    if(c == '"' || c == '\\') {
+      json += '\\';
+      json += static_cast<char>(c);
+    } else if(c < 0x20) {
+      char escape[8];
+      std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+      json += escape;
+    } else {
+      json += static_cast<char>(c);
+    }
+  }
+  json += '"';
+}
@@ -0,0 +1,111 @@
+/**
+ *
+ * Name        : msgpack_codec.hpp
+ * Version     : v0.7.4
+ * Description : MsgpackCodec Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef MSGPACK_CODEC_HPP_
+#define MSGPACK_CODEC_HPP_
+
+#include "wire_codec.hpp"
+
+/**
+ *  Websocket-Rails events as MessagePack over binary frames, with the
+ *  same structure as the JSON protocol: a frame is an array of events,
+ *  an event an array of its name and a map of its attributes.
+ *
+ *  Inbound frames are scanned in place like JSON frames: the name, id,
+ *  channel and tokens of an event point into the payload and its data
+ *  stays packed until getData() unpacks it straight into jsonxx. Only
+ *  filters see JSON text, transcoded from the data span on demand.
+ **/
+class MsgpackCodec : public WireCodec {
+public:
+
+  /**
+   *  Variables
+   **/
+  static const std::string subprotocol;
+  static const std::string ping_prefix;
+  static const std::string pong_frame;
+
+  /**
+   *  Functions
+   **/
+  WireFormat getFormat();
+  std::string getSubprotocol();
+  websocketpp::frame::opcode::value getOpcode();
+  std::string encode(Event event);
+  bool decode(const std::string & payload, FrameArena & arena, vec_frame_event & events);
+  bool isPing(const std::string & payload);
+  const std::string & getPongFrame();
+  static bool toJson(const std::string & payload, std::string & json);
+  static bool toJson(StringRef packed, FrameArena & arena, StringRef & json);
+  static bool unpack(StringRef packed, jsonxx::Object & object);
+  static bool findMember(StringRef map, const char * key, StringRef & value);
+  static bool fromJson(const std::string & json, std::string & payload);
+  static void pack(const jsonxx::Value & value, std::string & out);
+  static void pack(const jsonxx::Object & object, std::string & out);
+  static void pack(const jsonxx::Array & array, std::string & out);
+  static void pack(const std::string & str, std::string & out);
+
+private:
+
+  enum ItemType { ITEM_NIL, ITEM_BOOL, ITEM_UINT, ITEM_INT, ITEM_FLOAT32, ITEM_FLOAT64, ITEM_STR, ITEM_ARRAY, ITEM_MAP };
+
+  /**
+   *  Header of one MessagePack value; strings are read whole, arrays
+   *  and maps are followed by their elements.
+   **/
+  struct Item {
+    ItemType type;
+    bool boolean;
+    uint64_t uint;
+    int64_t sint;
+    double real;
+    StringRef str;
+    std::size_t size;         /* Elements of an array, pairs of a map */
+  };
+
+  /**
+   *  Functions
+   **/
+  static bool readItem(const unsigned char *& pos, const unsigned char * end, Item & item);
+  static bool skip(const unsigned char *& pos, const unsigned char * end, int depth);
+  static bool scanEvent(const unsigned char *& pos, const unsigned char * end, FrameArena & arena, FrameEvent & event);
+  static void scanAttributes(FrameEvent & event);
+  static bool readString(const unsigned char * pos, const unsigned char * end, StringRef & str);
+  static bool isMap(unsigned char code);
+  static bool unpackMap(const unsigned char *& pos, const unsigned char * end, std::size_t size, jsonxx::Object & object, int depth);
+  static bool unpackArray(const unsigned char *& pos, const unsigned char * end, std::size_t size, jsonxx::Array & array, int depth);
+  static jsonxx::Value toValue(const Item & item);
+  static void packHeader(unsigned char fix, unsigned char fix_max, unsigned char code16, std::size_t size, std::string & out);
+  static void packNumber(jsonxx::Number number, std::string & out);
+  static void packBig(uint64_t value, int bytes, std::string & out);
+  static uint64_t readBig(const unsigned char *& pos, int bytes);
+  static bool transcode(const unsigned char *& pos, const unsigned char * end, std::string & json, int depth);
+  static void quote(const char * str, std::size_t len, std::string & json);
+
+};
+
+
+#endif /* MSGPACK_CODEC_HPP_ */
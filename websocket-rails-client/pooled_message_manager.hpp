@@ -0,0 +1,116 @@
+/**
+ *
+ * Name        : pooled_message_manager.hpp
+ * Version     : v0.7.4
+ * Description : PooledMessageManager Header Template in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef POOLED_MESSAGE_MANAGER_HPP_
+#define POOLED_MESSAGE_MANAGER_HPP_
+
+#include "websocket.hpp"
+#include "message_pool.hpp"
+
+/**
+ *  websocketpp connection message manager whose message payloads come
+ *  from a MessagePool and go back to it when the last reference to the
+ *  message is dropped. It takes the pool installed on the thread that
+ *  creates the connection (see MessagePool::install).
+ **/
+template <typename message>
+class PooledMessageManager : public websocketpp::lib::enable_shared_from_this<PooledMessageManager<message> > {
+public:
+
+  /**
+   *  Type Definitions
+   **/
+  typedef PooledMessageManager<message> type;
+  typedef websocketpp::lib::shared_ptr<PooledMessageManager> ptr;
+  typedef websocketpp::lib::weak_ptr<PooledMessageManager> weak_ptr;
+  typedef typename message::ptr message_ptr;
+
+  /**
+   *  Constructors
+   **/
+  PooledMessageManager() : pool(MessagePool::installed()) {}
+  PooledMessageManager(boost::shared_ptr<MessagePool> pool) : pool(pool) {}
+
+  /**
+   *  Functions
+   **/
+  message_ptr get_message() {
+    message_ptr msg(new message(type::shared_from_this()), Recycler(this->pool));
+    this->pool->acquire(msg->get_raw_payload(), 0);
+    return msg;
+  }
+
+  message_ptr get_message(websocketpp::frame::opcode::value op, size_t size) {
+    message_ptr msg(new message(type::shared_from_this(), op, 0), Recycler(this->pool));
+    this->pool->acquire(msg->get_raw_payload(), size);
+    return msg;
+  }
+
+  /* A message around payload, which is swapped in instead of copied */
+  message_ptr wrap(websocketpp::frame::opcode::value op, std::string & payload) {
+    message_ptr msg(new message(type::shared_from_this(), op, 0), Recycler(this->pool));
+    msg->get_raw_payload().swap(payload);
+    return msg;
+  }
+
+  /* Payloads return through the deleter of the message pointer */
+  bool recycle(message *) {
+    return false;
+  }
+
+  boost::shared_ptr<MessagePool> getPool() {
+    return this->pool;
+  }
+
+private:
+
+  struct Recycler {
+    Recycler(boost::shared_ptr<MessagePool> pool) : pool(pool) {}
+    void operator()(message * msg) const {
+      this->pool->release(msg->get_raw_payload());
+      delete msg;
+    }
+    boost::shared_ptr<MessagePool> pool;
+  };
+
+  /**
+   *  Variables
+   **/
+  boost::shared_ptr<MessagePool> pool;
+
+};
+
+/**
+ *  Client config of websocketpp with pooled message buffers.
+ **/
+struct PooledClientConfig : public websocketpp::config::asio_client {
+  typedef PooledClientConfig type;
+  typedef websocketpp::message_buffer::message<PooledMessageManager> message_type;
+  typedef PooledMessageManager<message_type> con_msg_manager_type;
+  typedef websocketpp::message_buffer::alloc::endpoint_msg_manager<con_msg_manager_type> endpoint_msg_manager_type;
+};
+
+
+#endif /* POOLED_MESSAGE_MANAGER_HPP_ */
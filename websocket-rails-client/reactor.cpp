@@ -0,0 +1,92 @@
+/**
+ *
+ * Name        : reactor.cpp
+ * Version     : v0.7.4
+ * Description : Reactor Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "reactor.hpp"
+
+/* The reactor whose pool the current thread belongs to */
+static thread_local Reactor * current_reactor = NULL;
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+Reactor::Reactor(std::size_t threads) : wheel(io_service), work(boost::make_shared<boost::asio::io_service::work>(boost::ref(io_service))), threads(threads) {
+  for(std::size_t i = 0; i < threads; i++) {
+    this->pool.create_thread(boost::bind(&Reactor::run, this));
+  }
+}
+
+
+Reactor::~Reactor() {
+  this->stop();
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+boost::asio::io_service & Reactor::getIoService() {
+  return this->io_service;
+}
+
+
+TimerWheel & Reactor::getTimerWheel() {
+  return this->wheel;
+}
+
+
+std::size_t Reactor::getThreads() {
+  return this->threads;
+}
+
+
+/* True on the threads of the pool */
+bool Reactor::isReactorThread() {
+  return current_reactor == this;
+}
+
+
+/* Let the pool finish the queued handlers and join it, disconnect the dispatchers first */
+void Reactor::stop() {
+  this->work.reset();
+  this->pool.join_all();
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+void Reactor::run() {
+  current_reactor = this;
+  this->io_service.run();
+}
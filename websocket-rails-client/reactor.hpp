@@ -0,0 +1,77 @@
+/**
+ *
+ * Name        : reactor.hpp
+ * Version     : v0.7.4
+ * Description : Reactor Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef REACTOR_HPP_
+#define REACTOR_HPP_
+
+#include "websocket.hpp"
+#include "timer_wheel.hpp"
+
+/**
+ *  A fixed pool of threads running one io_service, shared by many
+ *  dispatchers. The websocketpp handlers of a connection are serialized
+ *  on its own strand, so one connection never runs on two threads at once.
+ *  The housekeeping of all its connections runs off one timer wheel.
+ **/
+class Reactor {
+public:
+
+  /**
+   *  Constructors
+   **/
+  Reactor(std::size_t threads);
+  ~Reactor();
+
+  /**
+   *  Functions
+   **/
+  boost::asio::io_service & getIoService();
+  TimerWheel & getTimerWheel();
+  std::size_t getThreads();
+  bool isReactorThread();
+  void stop();
+
+private:
+
+  /**
+   *  Variables
+   **/
+  boost::asio::io_service io_service;
+  TimerWheel wheel;
+  boost::shared_ptr<boost::asio::io_service::work> work;   /* Keeps the pool alive while no connection is open */
+  boost::thread_group pool;
+  std::size_t threads;
+
+  /**
+   *  Functions
+   **/
+  Reactor(const Reactor &);
+  Reactor & operator=(const Reactor &);
+  void run();
+
+};
+
+
+#endif /* REACTOR_HPP_ */
@@ -0,0 +1,200 @@
+/**
+ *
+ * Name        : session_handover.cpp
+ * Version     : v0.7.4
+ * Description : SessionHandover Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "session_handover.hpp"
+#include "logger.hpp"
+#include <poll.h>
+#include <unistd.h>
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+SessionHandover::SessionHandover(WebsocketRails & dispatcher) {
+  this->dispatcher = &dispatcher;
+}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Old process: wait for the new one on path, hand the session over and disconnect once it is connected.
+   If the new process does not confirm, the events taken go back to their queues and stay connected here;
+   their callbacks only learn of the handover once it is committed. */
+bool SessionHandover::offer(std::string path, long seconds) {
+  time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+  boost::system::error_code ec;
+  boost::asio::local::stream_protocol::acceptor acceptor(this->io_service);
+  ::unlink(path.c_str());
+  acceptor.open(boost::asio::local::stream_protocol(), ec);
+  if(!ec) {
+    acceptor.bind(boost::asio::local::stream_protocol::endpoint(path), ec);
+  }
+  if(!ec) {
+    acceptor.listen(1, ec);
+  }
+  if(!ec) {
+    acceptor.non_blocking(true, ec);
+  }
+  if(ec) {
+    WSR_LOG(LOG_ERROR, "Handover listen error (" + path + "): " + ec.message());
+    return false;
+  }
+  local_socket socket(this->io_service);
+  do {
+    acceptor.accept(socket, ec);
+    if(ec != boost::asio::error::would_block) {
+      break;
+    }
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  } while(std::chrono::steady_clock::now() < deadline);
+  acceptor.close();
+  ::unlink(path.c_str());
+  if(ec) {
+    WSR_LOG(LOG_WARN, "No process took the session over: " + ec.message());
+    return false;
+  }
+  socket.non_blocking(true, ec);
+  SessionExport session = this->dispatcher->takeSession();
+  std::string reply;
+  if(!write(socket, session.snapshot, deadline) || !read(socket, reply, deadline) || reply != "ready" || !write(socket, "commit", deadline)) {
+    WSR_LOG(LOG_WARN, "Handover not confirmed, keeping the session!");
+    this->dispatcher->restoreSession(session);
+    return false;
+  }
+  this->dispatcher->commitSession(session);
+  long remaining = std::chrono::duration_cast<std::chrono::seconds>(deadline - std::chrono::steady_clock::now()).count();
+  if(!this->dispatcher->drain(std::max(remaining, 1L))) {
+    WSR_LOG(LOG_WARN, "Results still pending at handover, they are given up!");
+  }
+  this->dispatcher->disconnect();
+  WSR_LOG(LOG_INFO, "Session handed over.");
+  return true;
+}
+
+
+/* New process: take the session offered on path, connect and confirm once the channels are subscribed.
+   The events of the session are only sent once the old process committed, so both never send them */
+bool SessionHandover::take(std::string path, long seconds) {
+  time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+  boost::system::error_code ec;
+  local_socket socket(this->io_service);
+  do {
+    socket.close(ec);
+    socket.connect(boost::asio::local::stream_protocol::endpoint(path), ec);
+    if(!ec) {
+      break;
+    }
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  } while(std::chrono::steady_clock::now() < deadline);
+  if(ec) {
+    WSR_LOG(LOG_WARN, "No session offered on " + path + ": " + ec.message());
+    return false;
+  }
+  socket.non_blocking(true, ec);
+  std::string snapshot;
+  if(!read(socket, snapshot, deadline)) {
+    return false;
+  }
+  if(this->dispatcher->connect() != "connected" || !this->dispatcher->importChannels(snapshot)) {
+    return false;
+  }
+  std::string reply;
+  if(!write(socket, "ready", deadline) || !read(socket, reply, deadline) || reply != "commit") {
+    WSR_LOG(LOG_WARN, "Handover not committed, the events stay with the old process!");
+    return false;
+  }
+  return this->dispatcher->importEvents(snapshot);
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+bool SessionHandover::wait(local_socket & socket, short events, time_point deadline) {
+  long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+  if(remaining <= 0) {
+    return false;
+  }
+  struct pollfd fd;
+  fd.fd = socket.native_handle();
+  fd.events = events;
+  fd.revents = 0;
+  return ::poll(&fd, 1, remaining) > 0;
+}
+
+
+/* Messages are their length in decimal, a newline and the message */
+bool SessionHandover::write(local_socket & socket, const std::string & message, time_point deadline) {
+  std::string frame = boost::lexical_cast<std::string>(message.size()) + "\n" + message;
+  std::size_t written = 0;
+  while(written < frame.size()) {
+    boost::system::error_code ec;
+    written += socket.write_some(boost::asio::buffer(frame.data() + written, frame.size() - written), ec);
+    if(ec == boost::asio::error::would_block) {
+      if(!wait(socket, POLLOUT, deadline)) {
+        return false;
+      }
+    } else if(ec) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool SessionHandover::read(local_socket & socket, std::string & message, time_point deadline) {
+  std::string buffer;
+  char chunk[4096];
+  for(;;) {
+    std::size_t newline = buffer.find('\n');
+    if(newline != std::string::npos) {
+      std::size_t size = std::strtoul(buffer.c_str(), NULL, 10);
+      if(buffer.size() - newline - 1 >= size) {
+        message = buffer.substr(newline + 1, size);
+        return true;
+      }
+    }
+    boost::system::error_code ec;
+    std::size_t received = socket.read_some(boost::asio::buffer(chunk), ec);
+    if(ec == boost::asio::error::would_block) {
+      if(!wait(socket, POLLIN, deadline)) {
+        return false;
+      }
+    } else if(ec) {
+      return false;
+    } else {
+      buffer.append(chunk, received);
+    }
+  }
+}
@@ -0,0 +1,77 @@
+/**
+ *
+ * Name        : session_handover.hpp
+ * Version     : v0.7.4
+ * Description : SessionHandover Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef SESSION_HANDOVER_HPP_
+#define SESSION_HANDOVER_HPP_
+
+#include "websocket_rails.hpp"
+
+/**
+ *  Make-before-break handover of a session between two processes on the
+ *  same host, over a Unix domain socket. The old process offers its
+ *  session; the new process takes it, connects, subscribes the channels
+ *  with the handed over tokens and sends the events the old process had
+ *  not sent yet. Once the new process is connected the old one waits for
+ *  the results of its events in flight and disconnects.
+ **/
+class SessionHandover {
+public:
+
+  /**
+   *  Type Definitions
+   **/
+  typedef boost::asio::local::stream_protocol::socket local_socket;
+  typedef std::chrono::steady_clock::time_point time_point;
+
+  /**
+   *  Constructors
+   **/
+  SessionHandover(WebsocketRails & dispatcher);
+
+  /**
+   *  Functions
+   **/
+  bool offer(std::string path, long seconds);
+  bool take(std::string path, long seconds);
+
+private:
+
+  /**
+   *  Variables
+   **/
+  WebsocketRails * dispatcher;
+  boost::asio::io_service io_service;
+
+  /**
+   *  Functions
+   **/
+  static bool wait(local_socket & socket, short events, time_point deadline);
+  static bool write(local_socket & socket, const std::string & message, time_point deadline);
+  static bool read(local_socket & socket, std::string & message, time_point deadline);
+
+};
+
+
+#endif /* SESSION_HANDOVER_HPP_ */
@@ -0,0 +1,57 @@
+/**
+ *
+ * Name        : string_pool.cpp
+ * Version     : v0.7.4
+ * Description : StringPool Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "string_pool.hpp"
+
+boost::shared_mutex StringPool::pool_mutex;
+std::tr1::unordered_set<std::string> StringPool::pool;
+const std::string StringPool::empty_string;
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Get the pooled copy of a string, adding it on first use; known names only take a shared lock */
+const std::string * StringPool::intern(const std::string & str) {
+  if(str.empty()) {
+    return &empty_string;
+  }
+  {
+    boost::shared_lock<boost::shared_mutex> guard(pool_mutex);
+    std::tr1::unordered_set<std::string>::const_iterator it = pool.find(str);
+    if(it != pool.end()) {
+      return &*it;
+    }
+  }
+  boost::unique_lock<boost::shared_mutex> guard(pool_mutex);
+  return &*pool.insert(str).first;
+}
+
+
+const std::string * StringPool::empty() {
+  return &empty_string;
+}
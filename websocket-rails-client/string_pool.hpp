@@ -0,0 +1,58 @@
+/**
+ *
+ * Name        : string_pool.hpp
+ * Version     : v0.7.4
+ * Description : StringPool Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef STRING_POOL_HPP_
+#define STRING_POOL_HPP_
+
+#include "websocket.hpp"
+
+/**
+ *  Process-wide pool of interned event names, a small set that is fixed
+ *  by the application. Interned strings are never released, so their
+ *  pointers can be kept and compared; ids, channel names, tokens and
+ *  connection ids are not bounded and are never interned.
+ **/
+class StringPool {
+public:
+
+  /**
+   *  Functions
+   **/
+  static const std::string * intern(const std::string & str);
+  static const std::string * empty();
+
+private:
+
+  /**
+   *  Variables
+   **/
+  static boost::shared_mutex pool_mutex;
+  static std::tr1::unordered_set<std::string> pool;
+  static const std::string empty_string;
+
+};
+
+
+#endif /* STRING_POOL_HPP_ */
@@ -0,0 +1,96 @@
+/**
+ *
+ * Name        : timer_wheel.cpp
+ * Version     : v0.7.4
+ * Description : TimerWheel Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+
+#include "timer_wheel.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+TimerWheel::TimerWheel(boost::asio::io_service & io_service) : timer(io_service), slots(TIMER_WHEEL_SLOTS), next_id(1), current(0), count(0), armed(false) {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+/* Call handler once per TICK_INTERVAL until the entry is removed, returns the id of the entry */
+std::size_t TimerWheel::add(boost::function<void()> handler) {
+  boost::lock_guard<boost::mutex> guard(this->wheel_mutex);
+  std::size_t id = this->next_id++;
+  this->slots[id % TIMER_WHEEL_SLOTS][id] = handler;
+  this->count++;
+  if(!this->armed) {
+    this->armed = true;
+    this->schedule();
+  }
+  return id;
+}
+
+
+/* The handler of the entry is not running and will not be called again once this returns */
+void TimerWheel::remove(std::size_t id) {
+  boost::lock_guard<boost::mutex> guard(this->wheel_mutex);
+  this->count -= this->slots[id % TIMER_WHEEL_SLOTS].erase(id);
+}
+
+
+std::size_t TimerWheel::size() {
+  boost::lock_guard<boost::mutex> guard(this->wheel_mutex);
+  return this->count;
+}
+
+
+
+/********************************************************
+ *                                                      *
+ * PRIVATE METHODS                                      *
+ *                                                      *
+ ********************************************************/
+
+void TimerWheel::schedule() {
+  this->timer.expires_from_now(std::chrono::milliseconds(TICK_INTERVAL / TIMER_WHEEL_SLOTS));
+  this->timer.async_wait(boost::bind(&TimerWheel::turn, this, boost::asio::placeholders::error));
+}
+
+
+/* Call the entries of the current slot and move on, the timer stops with the last entry so the loop can run out of work */
+void TimerWheel::turn(const boost::system::error_code & ec) {
+  boost::lock_guard<boost::mutex> guard(this->wheel_mutex);
+  if(ec || this->count == 0) {
+    this->armed = false;
+    return;
+  }
+  map_handler & slot = this->slots[this->current];
+  for(map_handler::iterator it = slot.begin(); it != slot.end(); ++it) {
+    it->second();
+  }
+  this->current = (this->current + 1) % TIMER_WHEEL_SLOTS;
+  this->schedule();
+}
@@ -0,0 +1,80 @@
+/**
+ *
+ * Name        : timer_wheel.hpp
+ * Version     : v0.7.4
+ * Description : TimerWheel Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef TIMER_WHEEL_HPP_
+#define TIMER_WHEEL_HPP_
+
+#include "websocket.hpp"
+
+/**
+ *  One timer for the housekeeping of all connections on a reactor.
+ *  Entries are spread over TIMER_WHEEL_SLOTS slots and the wheel turns
+ *  one slot every TICK_INTERVAL / TIMER_WHEEL_SLOTS milliseconds, so
+ *  every entry is called once per TICK_INTERVAL and a turn only calls
+ *  the entries of one slot. Handlers run with the wheel locked and must
+ *  only post work; the timer is armed while the wheel has entries.
+ **/
+class TimerWheel {
+public:
+
+  /**
+   *  Constructors
+   **/
+  TimerWheel(boost::asio::io_service & io_service);
+
+  /**
+   *  Functions
+   **/
+  std::size_t add(boost::function<void()> handler);
+  void remove(std::size_t id);
+  std::size_t size();
+
+private:
+
+  typedef std::tr1::unordered_map<std::size_t, boost::function<void()> > map_handler;
+
+  /**
+   *  Variables
+   **/
+  boost::asio::steady_timer timer;
+  boost::mutex wheel_mutex;
+  std::vector<map_handler> slots;   /* Map<key,value>: Entry Id, Handler, by slot */
+  std::size_t next_id;
+  std::size_t current;              /* Slot of the next turn */
+  std::size_t count;
+  bool armed;
+
+  /**
+   *  Functions
+   **/
+  TimerWheel(const TimerWheel &);
+  TimerWheel & operator=(const TimerWheel &);
+  void schedule();
+  void turn(const boost::system::error_code & ec);
+
+};
+
+
+#endif /* TIMER_WHEEL_HPP_ */
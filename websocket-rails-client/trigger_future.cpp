@@ -0,0 +1,165 @@
+/**
+ *
+ * Name        : trigger_future.cpp
+ * Version     : v0.7.4
+ * Description : TriggerFuture Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "trigger_future.hpp"
+#include "websocket_rails.hpp"
+
+
+
+#if __cplusplus >= 202002L
+/* The stage decides who resumes the coroutine: complete if it is suspended, await_suspend if it is done first, nobody
+   once the awaitable is gone */
+struct TriggerAwaitable::State {
+  enum Stage {PENDING, SUSPENDED, DONE, ABANDONED};
+  State() : stage(PENDING), success(false) {}
+  boost::atomic<int> stage;
+  std::coroutine_handle<> handle;
+  bool success;
+  jsonxx::Object result;
+};
+#endif
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+TriggerError::TriggerError(jsonxx::Object data) : std::runtime_error("Event failed: " + data.json()), data(data) {}
+
+
+TriggerFuture::TriggerFuture(WebsocketRails & dispatcher, std::string id, std::future<jsonxx::Object> future) : id(id), future(std::move(future)) {
+  this->dispatcher = &dispatcher;
+}
+
+
+#if __cplusplus >= 202002L
+/* The event is made here, so its id is known before the coroutine awaits it */
+TriggerAwaitable::TriggerAwaitable(WebsocketRails & dispatcher, std::string event_name, jsonxx::Object event_data, long timeout)
+  : timeout(timeout), state(boost::make_shared<State>()) {
+  this->dispatcher = &dispatcher;
+  jsonxx::Array data;
+  data << event_name << event_data << (dispatcher.getConn() != NULL ? dispatcher.getConn()->getConnectionId() : "");
+  this->event = Event(data);
+}
+
+
+/* Gone while suspended, i.e. the frame of the coroutine was destroyed: the event is cancelled, nothing is resumed */
+TriggerAwaitable::~TriggerAwaitable() {
+  if(this->state->stage.exchange(State::ABANDONED) == State::SUSPENDED) {
+    this->dispatcher->cancel(this->event.getId());
+  }
+}
+#endif
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+jsonxx::Object TriggerError::getData() const {
+  return this->data;
+}
+
+
+/* Wait for the result, throws a TriggerError if the event failed */
+jsonxx::Object TriggerFuture::get() {
+  return this->future.get();
+}
+
+
+/* Wait up to timeout milliseconds, returns true once the result is there */
+bool TriggerFuture::waitFor(long timeout) {
+  return this->future.wait_for(std::chrono::milliseconds(timeout)) == std::future_status::ready;
+}
+
+
+/* Give up on the result, the future fails with {"error": "cancelled"} */
+bool TriggerFuture::cancel() {
+  return this->dispatcher->cancel(this->id);
+}
+
+
+std::string TriggerFuture::getId() {
+  return this->id;
+}
+
+
+std::future<jsonxx::Object> & TriggerFuture::getFuture() {
+  return this->future;
+}
+
+
+void TriggerFuture::resolve(boost::shared_ptr<std::promise<jsonxx::Object> > promise, jsonxx::Object data) {
+  promise->set_value(data);
+}
+
+
+void TriggerFuture::reject(boost::shared_ptr<std::promise<jsonxx::Object> > promise, jsonxx::Object data) {
+  promise->set_exception(std::make_exception_ptr(TriggerError(data)));
+}
+
+
+#if __cplusplus >= 202002L
+/* Returns false when the result came before trigger returned, the coroutine then goes on without suspending */
+bool TriggerAwaitable::await_suspend(std::coroutine_handle<> handle) {
+  this->state->handle = handle;
+  this->dispatcher->triggerWindowed(this->event,
+                                    boost::bind(&TriggerAwaitable::complete, this->state, true, _1),
+                                    boost::bind(&TriggerAwaitable::complete, this->state, false, _1),
+                                    this->timeout);
+  int expected = State::PENDING;
+  return this->state->stage.compare_exchange_strong(expected, State::SUSPENDED);
+}
+
+
+jsonxx::Object TriggerAwaitable::await_resume() {
+  if(!this->state->success) {
+    throw TriggerError(this->state->result);
+  }
+  return this->state->result;
+}
+
+
+std::string TriggerAwaitable::getId() {
+  return this->event.getId();
+}
+
+
+/* Give up on the result, the coroutine resumes with a TriggerError {"error": "cancelled"} */
+bool TriggerAwaitable::cancel() {
+  return this->dispatcher->cancel(this->event.getId());
+}
+
+
+void TriggerAwaitable::complete(boost::shared_ptr<State> state, bool success, jsonxx::Object data) {
+  state->success = success;
+  state->result = data;
+  if(state->stage.exchange(State::DONE) == State::SUSPENDED) {
+    state->handle.resume();
+  }
+}
+#endif
@@ -0,0 +1,154 @@
+/**
+ *
+ * Name        : trigger_future.hpp
+ * Version     : v0.7.4
+ * Description : TriggerFuture Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef TRIGGER_FUTURE_HPP_
+#define TRIGGER_FUTURE_HPP_
+
+#include "websocket.hpp"
+#include "event.hpp"
+#include <future>
+#include <stdexcept>
+#if __cplusplus >= 202002L
+#include <coroutine>
+#endif
+
+class WebsocketRails;
+
+/**
+ *  Thrown by a TriggerFuture or a TriggerAwaitable when the event failed.
+ *  The data is the failure payload of the server, or {"error": "timeout"}
+ *  and {"error": "cancelled"} for results that never arrived.
+ **/
+class TriggerError : public std::runtime_error {
+public:
+
+  /**
+   *  Constructors
+   **/
+  TriggerError(jsonxx::Object data);
+  ~TriggerError() throw() {}
+
+  /**
+   *  Functions
+   **/
+  jsonxx::Object getData() const;
+
+private:
+
+  /**
+   *  Variables
+   **/
+  jsonxx::Object data;
+
+};
+
+
+/**
+ *  Result of WebsocketRails::triggerAsync. Resolved from the asio thread
+ *  when the result of the event arrives, it times out or it is cancelled.
+ **/
+class TriggerFuture {
+public:
+
+  /**
+   *  Constructors
+   **/
+  TriggerFuture(WebsocketRails & dispatcher, std::string id, std::future<jsonxx::Object> future);
+
+  /**
+   *  Functions
+   **/
+  jsonxx::Object get();
+  bool waitFor(long timeout);
+  bool cancel();
+  std::string getId();
+  std::future<jsonxx::Object> & getFuture();
+  static void resolve(boost::shared_ptr<std::promise<jsonxx::Object> > promise, jsonxx::Object data);
+  static void reject(boost::shared_ptr<std::promise<jsonxx::Object> > promise, jsonxx::Object data);
+
+private:
+
+  /**
+   *  Variables
+   **/
+  WebsocketRails * dispatcher;
+  std::string id;
+  std::future<jsonxx::Object> future;
+
+};
+
+
+#if __cplusplus >= 202002L
+/**
+ *  C++20 awaitable for WebsocketRails::triggerAwait, the coroutine resumes
+ *  on the thread that delivers the result or cancels the event, or does
+ *  not suspend at all when the result is there before trigger returns
+ *  (e.g. a full window). cancel() ends a suspended coroutine early with
+ *  {"error": "cancelled"}. Destroying the frame of a suspended coroutine
+ *  cancels the event without resuming it; it must not race with its
+ *  result, so destroy it on the IO thread or cancel() first.
+ **/
+class TriggerAwaitable {
+public:
+
+  /**
+   *  Constructors
+   **/
+  TriggerAwaitable(WebsocketRails & dispatcher, std::string event_name, jsonxx::Object event_data, long timeout);
+
+  /**
+   *  Functions
+   **/
+  ~TriggerAwaitable();
+  bool await_ready() { return false; }
+  bool await_suspend(std::coroutine_handle<> handle);
+  jsonxx::Object await_resume();
+  std::string getId();
+  bool cancel();
+
+private:
+
+  struct State;
+
+  /**
+   *  Variables
+   **/
+  WebsocketRails * dispatcher;
+  Event event;
+  long timeout;
+  boost::shared_ptr<State> state;  /* Shared with the callbacks of the event, they may outlive the awaitable */
+
+  /**
+   *  Functions
+   **/
+  TriggerAwaitable(const TriggerAwaitable &);
+  TriggerAwaitable & operator=(const TriggerAwaitable &);
+  static void complete(boost::shared_ptr<State> state, bool success, jsonxx::Object data);
+
+};
+#endif
+
+
+#endif /* TRIGGER_FUTURE_HPP_ */
@@ -26,28 +26,56 @@
 #define WEBSOCKET_HPP_
 
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
 #include <tr1/unordered_map>
+#include <tr1/unordered_set>
 #include <vector>
 #include <queue>
+#include <deque>
+#include <map>
+#include <chrono>
 #include <jsonxx/jsonxx.h>
 
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/thread.hpp>
+#include <boost/atomic.hpp>
 #include <boost/date_time.hpp>
 
 #include <websocketpp/config/asio_no_tls_client.hpp>
 #include <websocketpp/client.hpp>
 #include <websocketpp/common/thread.hpp>
 
-#define TIMEOUT_CONN 5
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
-typedef boost::function<void(jsonxx::Object)> cb_func;
-typedef std::vector<boost::function<void(jsonxx::Object)> > vec_cb_func;
-typedef std::tr1::unordered_map<std::string, vec_cb_func> map_vec_cb_func;
+#define TIMEOUT_CONN 5
+#define FRAME_ARENA_BLOCK 4096
+#define TICK_INTERVAL 100
+#define TIMER_WHEEL_SLOTS 10
+#define LANE_HIGH_WATER 16384
+#define LANE_RETRY 1
+#define LANE_CONTROL_SHARE 8
+#define LANE_BULK_SHARE 1
+#define CALLBACK_HISTOGRAM_BUCKETS 32
+#define PROFILER_PRUNE_MIN 64
+#define MESSAGE_POOL_MIN 256
+#define MESSAGE_POOL_CLASSES 5
+#define MESSAGE_POOL_DEPTH 32
+#define HEARTBEAT_MAX_MISSED 2
+#define RACE_STAGGER 250
+#define CALLBACK_INLINE_SIZE 48
+#define WINDOW_BLOCK_TIMEOUT 5000
 
 #endif /* WEBSOCKET_HPP_ */
@@ -24,6 +24,7 @@
 
 #include "websocket_connection.hpp"
 #include "websocket_rails.hpp"
+#include "logger.hpp"
 
 
 
@@ -31,27 +32,44 @@
  *  Constructor                     *
  ************************************/
 
-WebsocketConnection::WebsocketConnection(std::string url, WebsocketRails & dispatcher) : url(url) {
+WebsocketConnection::WebsocketConnection(std::string url, WebsocketRails & dispatcher) : url(url), frame_arena(dispatcher.getFrameArenaSize()), interval_total(0), latency_total(0), tick_id(0), closed(false), aborted(false), ticking(false), tick_pending(false), lane_turn(0), drain_pending(false), monitor(dispatcher.getHeartbeatPolicy()) {
   const std::string connection_type = "websocket";
   this->dispatcher = &dispatcher;
-
-  /* Set up access channels to only log interesting things */
+  this->control_share = dispatcher.getControlShare();
+  this->bulk_share = dispatcher.getBulkShare();
+  this->latency_profile = dispatcher.getLatencyProfile();
+  this->codec = WireCodec::create(dispatcher.getWireFormat());
+  this->message_pool = boost::make_shared<MessagePool>();
+  this->messages = websocketpp::lib::make_shared<message_manager>(this->message_pool);
+
+  /* Set up access channels to only log interesting things, application logs go through the Logger */
   this->ws_client.clear_access_channels(websocketpp::log::alevel::all);
   this->ws_client.set_access_channels(websocketpp::log::alevel::connect);
   this->ws_client.set_access_channels(websocketpp::log::alevel::disconnect);
-  this->ws_client.set_access_channels(websocketpp::log::alevel::app);
 
-  /* Initialize the Asio transport policy */
-  this->ws_client.init_asio();
+  /* Initialize the Asio transport policy, on the caller's loop if there is one */
+  if(dispatcher.getIoService() != NULL) {
+    this->ws_client.init_asio(dispatcher.getIoService());
+  } else {
+    this->ws_client.init_asio();
+  }
 
   /* Bind the handlers we are using */
   using websocketpp::lib::placeholders::_1;
   using websocketpp::lib::placeholders::_2;
   using websocketpp::lib::bind;
+  this->ws_client.set_tcp_post_init_handler(bind(&WebsocketConnection::socketHandler,this,::_1));
   this->ws_client.set_open_handler(bind(&WebsocketConnection::openHandler,this,::_1));
   this->ws_client.set_close_handler(bind(&WebsocketConnection::closeHandler,this,::_1));
   this->ws_client.set_fail_handler(bind(&WebsocketConnection::failHandler,this,::_1));
   this->ws_client.set_message_handler(bind(&WebsocketConnection::messageHandler,this,::_1,::_2));
+  this->ws_client.set_pong_handler(bind(&WebsocketConnection::pongHandler,this,::_1,::_2));
+}
+
+
+/* The close handler takes the connection off the timer wheel, unless the loop never got to run it */
+WebsocketConnection::~WebsocketConnection() {
+  this->stopTicker();
 }
 
 
@@ -60,25 +78,60 @@ WebsocketConnection::WebsocketConnection(std::string url, WebsocketRails & dispa
  *  Functions                       *
  ************************************/
 
-/* This method will block until the connection is complete */
-void WebsocketConnection::run() {
+/* Queue the connection on the loop, the handshake happens once the loop runs */
+bool WebsocketConnection::start() {
   websocketpp::lib::error_code ec;
+  /* The message manager of the connection picks up the pool installed while it is created */
+  MessagePool * previous = MessagePool::install(this->message_pool.get());
   client::connection_ptr conn_ptr = this->ws_client.get_connection(this->url, ec);
+  MessagePool::install(previous);
   if (ec) {
-    this->ws_client.get_alog().write(websocketpp::log::alevel::app,
-    "Get Connection Error (" + this->url + "): " + ec.message());
-    return;
+    WSR_LOG(LOG_ERROR, "Get Connection Error (" + this->url + "): " + ec.message());
+    this->closed = true;
+    return false;
+  }
+  /* JSON needs no subprotocol, servers without one for the codec answer with none and get JSON */
+  if(!this->codec->getSubprotocol().empty()) {
+    conn_ptr->add_subprotocol(this->codec->getSubprotocol(), ec);
   }
   this->ws_hdl = conn_ptr->get_handle();
   this->ws_client.connect(conn_ptr);
-  websocketpp::lib::thread asio_thread(&client::run, &this->ws_client);
-  asio_thread.join();
+  return true;
+}
+
+
+/* This method will block until the connection is complete, the loop runs on the calling thread */
+void WebsocketConnection::run() {
+  this->pinThread();
+  if(!this->start()) {
+    return;
+  }
+  if(this->latency_profile.spin) {
+    /* poll() stops the loop once it runs out of work, like run() returns */
+    while(!this->ws_client.stopped()) {
+      this->ws_client.poll();
+    }
+  } else {
+    this->ws_client.run();
+  }
+}
+
+
+/* True once the connection is closed or failed */
+bool WebsocketConnection::isClosed() {
+  return this->closed;
+}
+
+
+/* True once the connection is closed and none of its timers or posted handlers is left on the loop */
+bool WebsocketConnection::isIdle() {
+  websocket_lock guard(this->lane_mutex);
+  return this->closed && !this->ticking && !this->tick_pending && !this->drain_pending;
 }
 
 
 void WebsocketConnection::close() {
-  this->ws_client.get_alog().write(websocketpp::log::alevel::app,
-  "Connection closed by client!");
+  WSR_LOG(LOG_INFO, "Connection closed by client!");
   websocket_lock guard(ws_mutex);
   if(this->dispatcher && this->dispatcher->getConn() == this) {
     this->ws_client.close(this->ws_hdl, websocketpp::close::status::normal, "Close by client.");
@@ -88,7 +141,9 @@ void WebsocketConnection::close() {
 
 /* Trigger an event on the server */
 void WebsocketConnection::trigger(Event event) {
-  if(this->dispatcher->getState() != "connected") {
+  /* Events triggered while the queue is being flushed go behind it */
+  websocket_lock guard(this->queue_mutex);
+  if(!this->dispatcher->isConnected() || !this->event_queue.empty()) {
     this->event_queue.push(event);
   } else {
     this->sendEvent(event);
@@ -96,6 +151,63 @@ void WebsocketConnection::trigger(Event event) {
 }
 
 
+/* Answer a server ping */
+void WebsocketConnection::pong() {
+  this->pong(std::chrono::steady_clock::now());
+}
+
+
+/* Get the heartbeat statistics */
+HeartbeatStats WebsocketConnection::getHeartbeatStats() {
+  websocket_lock guard(this->stats_mutex);
+  return this->heartbeat_stats;
+}
+
+
+/* True on the thread that runs the websocket handlers */
+bool WebsocketConnection::isIoThread() {
+  if(this->dispatcher->getReactor() != NULL) {
+    return this->dispatcher->getReactor()->isReactorThread();
+  }
+  return boost::this_thread::get_id() == this->io_thread;
+}
+
+
+/* Frames taken from each lane per round while both have frames waiting */
+void WebsocketConnection::setLaneShares(unsigned int control_share, unsigned int bulk_share) {
+  websocket_lock guard(this->lane_mutex);
+  this->control_share = control_share;
+  this->bulk_share = bulk_share;
+  this->lane_turn = 0;
+}
+
+
+/* Get the outbound lane counters */
+LaneStats WebsocketConnection::getLaneStats() {
+  websocket_lock guard(this->lane_mutex);
+  LaneStats stats = this->lane_stats;
+  stats.control_queued = this->control_lane.size();
+  stats.bulk_queued = this->bulk_lane.size();
+  return stats;
+}
+
+
+LivenessStats WebsocketConnection::getLivenessStats() {
+  return this->monitor.getStats();
+}
+
+
+/* False once the heartbeat monitor declared the connection dead */
+bool WebsocketConnection::isAlive() {
+  return !this->monitor.isDead();
+}
+
+
+MessagePoolStats WebsocketConnection::getMessagePoolStats() {
+  return this->message_pool->getStats();
+}
+
+
 /* Set the connection id */
 std::string WebsocketConnection::setConnectionId(std::string connection_id) {
   return this->connection_id = connection_id;
@@ -108,11 +220,28 @@ std::string WebsocketConnection::getConnectionId() {
 }
 
 
+std::string WebsocketConnection::getUrl() {
+  return this->url;
+}
+
+
+/* Drop the connection without a close handshake, e.g. the loser of a connect race. A loop of its own is
+   stopped, the socket of a connection on a shared loop is closed on its strand */
+void WebsocketConnection::abort() {
+  this->aborted = true;
+  if(this->dispatcher->getIoService() == NULL) {
+    this->ws_client.stop();
+  } else {
+    this->postHandler(boost::bind(&WebsocketConnection::abortHandler, this));
+  }
+}
+
+
 /* Flush all events in queue */
 std::queue<Event> WebsocketConnection::flushQueue() {
+  websocket_lock guard(this->queue_mutex);
   while(!this->event_queue.empty()) {
-    Event event = this->event_queue.front();
-    this->trigger(event);
+    this->sendEvent(this->event_queue.front());
     this->event_queue.pop();
   }
   std::swap(this->event_queue, this->empty);
@@ -120,6 +249,31 @@ std::queue<Event> WebsocketConnection::flushQueue() {
 }
 
 
+/* Take the events waiting for the connection instead of sending them */
+std::queue<Event> WebsocketConnection::takeQueue() {
+  websocket_lock guard(this->queue_mutex);
+  std::queue<Event> queued;
+  std::swap(this->event_queue, queued);
+  return queued;
+}
+
+
+/* Put events taken with takeQueue back ahead of the ones queued since, sent at once if connected */
+void WebsocketConnection::restoreQueue(std::queue<Event> queued) {
+  websocket_lock guard(this->queue_mutex);
+  for(; !this->event_queue.empty(); this->event_queue.pop()) {
+    queued.push(this->event_queue.front());
+  }
+  std::swap(this->event_queue, queued);
+  if(!this->dispatcher->isConnected()) {
+    return;
+  }
+  for(; !this->event_queue.empty(); this->event_queue.pop()) {
+    this->sendEvent(this->event_queue.front());
+  }
+}
+
+
 
 /********************************************************
  *                                                      *
@@ -129,21 +283,95 @@ std::queue<Event> WebsocketConnection::flushQueue() {
 
 /* The open handler will signal that we are ready to start sending */
 void WebsocketConnection::openHandler(websocketpp::connection_hdl hdl) {
-  this->ws_client.get_alog().write(websocketpp::log::alevel::app,
-  "Connection opened, starting websocket!");
+  WSR_LOG(LOG_INFO, "Connection opened, starting websocket!");
   websocket_lock guard(ws_mutex);
+  this->io_thread = boost::this_thread::get_id();
+  websocketpp::lib::error_code ec;
+  client::connection_ptr con = this->ws_client.get_con_from_hdl(hdl, ec);
+  if(!ec && con->get_subprotocol() != this->codec->getSubprotocol()) {
+    WSR_LOG(LOG_WARN, "Subprotocol " + this->codec->getSubprotocol() + " declined, falling back to JSON!");
+    this->codec = WireCodec::create(con->get_subprotocol());
+  }
+  this->monitor.start(std::chrono::steady_clock::now());
+  this->startTicker();
+}
+
+
+/* Apply the socket options of the latency profile once the TCP connection is up */
+void WebsocketConnection::socketHandler(websocketpp::connection_hdl hdl) {
+  websocketpp::lib::error_code ec;
+  client::connection_ptr con = this->ws_client.get_con_from_hdl(hdl, ec);
+  if(ec) {
+    return;
+  }
+  boost::asio::ip::tcp::socket & socket = con->get_raw_socket();
+  boost::system::error_code option_ec;
+  /* Aborted while the name was resolved, the socket did not exist yet */
+  if(this->aborted) {
+    socket.close(option_ec);
+    return;
+  }
+  /* Each option on its own, a failed one is not hidden by the next */
+  if(this->latency_profile.tcp_nodelay) {
+    socket.set_option(boost::asio::ip::tcp::no_delay(true), option_ec);
+    if(option_ec) {
+      WSR_LOG(LOG_WARN, "TCP_NODELAY not applied: " + option_ec.message());
+    }
+  }
+  if(this->latency_profile.send_buffer > 0) {
+    socket.set_option(boost::asio::socket_base::send_buffer_size(this->latency_profile.send_buffer), option_ec);
+    if(option_ec) {
+      WSR_LOG(LOG_WARN, "SO_SNDBUF not applied: " + option_ec.message());
+    }
+  }
+  if(this->latency_profile.receive_buffer > 0) {
+    socket.set_option(boost::asio::socket_base::receive_buffer_size(this->latency_profile.receive_buffer), option_ec);
+    if(option_ec) {
+      WSR_LOG(LOG_WARN, "SO_RCVBUF not applied: " + option_ec.message());
+    }
+  }
+#ifdef SO_BUSY_POLL
+  if(this->latency_profile.busy_poll > 0) {
+    int busy_poll = this->latency_profile.busy_poll;
+    if(setsockopt(socket.native_handle(), SOL_SOCKET, SO_BUSY_POLL, &busy_poll, sizeof(busy_poll)) != 0) {
+      WSR_LOG(LOG_WARN, "SO_BUSY_POLL not applied, it needs CAP_NET_ADMIN above net.core.busy_read");
+    }
+  }
+#endif
+}
+
+
+/* Pin the thread running the loop to the CPU of the latency profile */
+void WebsocketConnection::pinThread() {
+  if(this->latency_profile.cpu < 0) {
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(this->latency_profile.cpu, &cpus);
+  if(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+    WSR_LOG(LOG_WARN, "Could not pin the IO thread to CPU " + boost::lexical_cast<std::string>(this->latency_profile.cpu));
+  }
+#endif
 }
 
 
 /* The close handler will signal that we should stop sending */
 void WebsocketConnection::closeHandler(websocketpp::connection_hdl hdl) {
-  this->ws_client.get_alog().write(websocketpp::log::alevel::app,
-  "Connection closed, stopping websocket!");
+  WSR_LOG(LOG_INFO, "Connection closed, stopping websocket!");
   websocket_lock guard(ws_mutex);
+  this->closed = true;
+  this->stopTicker();
   if(this->dispatcher && this->dispatcher->getConn() == this) {
-    this->dispatcher->setState("disconnected");
+    /* Only a lost connection changes the state, closes and reconnects by the client keep theirs */
+    if(this->dispatcher->setState(STATE_CONNECTED, STATE_DISCONNECTED)) {
+      this->dispatcher->endpointFailed(this->url);
+    } else {
+      this->dispatcher->setState(STATE_CONNECTING, STATE_DISCONNECTED);
+    }
     if(this->dispatcher->getOnCloseCallback()) {
-      cb_func callback = this->dispatcher->getOnCloseCallback();
+      const cb_func & callback = this->dispatcher->getOnCloseCallback();
       callback(jsonxx::Object("connection_id", this->connection_id));
     }
   }
@@ -152,13 +380,19 @@ void WebsocketConnection::closeHandler(websocketpp::connection_hdl hdl) {
 
 /* The fail handler will signal that we should stop sending */
 void WebsocketConnection::failHandler(websocketpp::connection_hdl hdl) {
-  this->ws_client.get_alog().write(websocketpp::log::alevel::app,
-  "Connection failed, stopping websocket!");
+  WSR_LOG(LOG_WARN, "Connection failed, stopping websocket!");
   websocket_lock guard(ws_mutex);
+  this->closed = true;
+  this->stopTicker();
   if(this->dispatcher && this->dispatcher->getConn() == this) {
-    this->dispatcher->setState("disconnected");
+    /* Only a lost connection changes the state, closes and reconnects by the client keep theirs */
+    if(this->dispatcher->setState(STATE_CONNECTED, STATE_DISCONNECTED)) {
+      this->dispatcher->endpointFailed(this->url);
+    } else {
+      this->dispatcher->setState(STATE_CONNECTING, STATE_DISCONNECTED);
+    }
     if(this->dispatcher->getOnFailCallback()) {
-      cb_func callback = this->dispatcher->getOnFailCallback();
+      const cb_func & callback = this->dispatcher->getOnFailCallback();
       callback(jsonxx::Object("connection_id", this->connection_id));
     }
   }
@@ -167,20 +401,38 @@ void WebsocketConnection::failHandler(websocketpp::connection_hdl hdl) {
 
 /* The message handler will signal that we have received a message */
 void WebsocketConnection::messageHandler(websocketpp::connection_hdl hdl, message_ptr msg) {
-  std::string event_names;
-  std::string tmp = msg->get_payload();
-  jsonxx::Array event_data;
-  event_data.parse(tmp);
-  for(int i = 0, len = event_data.size(); i < len; i++) {
-    event_names += event_data.get<jsonxx::Array>(i).get<jsonxx::String>(0) + " ";
+  time_point received = std::chrono::steady_clock::now();
+  /* Answer pings right here on the asio thread, without parsing the frame */
+  if(this->codec->isPing(msg->get_payload())) {
+    this->monitor.ping(received);
+    this->pong(received);
+    return;
+  }
+  this->monitor.activity(received);
+  /* All transient allocations of the frame live in the arena until it is dispatched */
+  this->frame_arena.reset();
+  vec_frame_event event_data((ArenaAllocator<FrameEvent>(this->frame_arena)));
+  if(!this->codec->decode(msg->get_payload(), this->frame_arena, event_data)) {
+    WSR_LOG(LOG_WARN, "Malformed message dropped!");
+    return;
   }
-  if(event_names != "websocket_rails.ping ") {
-    this->ws_client.get_alog().write(websocketpp::log::alevel::app,
-    "Message arrived: " + event_names);
+  if(WSR_LOG_ENABLED(LOG_DEBUG)) {
+    std::string event_names;
+    for(vec_frame_event::iterator it = event_data.begin(); it != event_data.end(); ++it) {
+      event_names += it->getName().str() + " ";
+    }
+    if(event_names != "websocket_rails.ping ") {
+      WSR_LOG(LOG_DEBUG, "Message arrived: " + event_names);
+    }
   }
   if(this->dispatcher && this->dispatcher->getConn() == this) {
     this->dispatcher->newMessage(event_data);
+  } else if(this->dispatcher) {
+    /* A candidate of a connect race, the winner becomes the connection on its client_connected */
+    this->dispatcher->candidateMessage(this, event_data);
   }
+  event_data.clear();
+  this->frame_arena.reset();
 }
 
 
@@ -188,10 +440,218 @@ void WebsocketConnection::sendEvent(Event event) {
   if(this->connection_id != "") {
     event.setConnectionId(this->connection_id);
   }
+  std::string name = event.getName();
+  this->send(this->codec->encode(event), name.compare(0, 16, "websocket_rails.") == 0 ? LANE_CONTROL : LANE_BULK);
+}
+
+
+/* Queue a frame on its lane, the lanes are drained on the strand of the connection */
+void WebsocketConnection::send(std::string payload, OutboundLane lane) {
+  {
+    websocket_lock guard(this->lane_mutex);
+    std::deque<std::string> & queue = lane == LANE_CONTROL ? this->control_lane : this->bulk_lane;
+    queue.push_back(std::string());
+    queue.back().swap(payload);
+    if(this->drain_pending) {
+      return;
+    }
+    this->drain_pending = true;
+  }
+  this->dispatchHandler(boost::bind(&WebsocketConnection::drainLanes, this));
+}
+
+
+/* Hand frames to websocketpp while its send buffer is below the high water mark */
+void WebsocketConnection::drainLanes() {
+  websocketpp::lib::error_code ec;
+  client::connection_ptr con = this->ws_client.get_con_from_hdl(this->ws_hdl, ec);
+  if(ec || this->closed) {
+    websocket_lock guard(this->lane_mutex);
+    this->drain_pending = false;
+    return;
+  }
+  std::string payload;
+  while(con->get_buffered_amount() < LANE_HIGH_WATER) {
+    {
+      websocket_lock guard(this->lane_mutex);
+      if(!this->nextFrame(payload)) {
+        this->drain_pending = false;
+        return;
+      }
+    }
+    /* The payload moves into the message, its buffer goes to the pool once the frame is written */
+    this->ws_client.send(this->ws_hdl, this->messages->wrap(this->codec->getOpcode(), payload), ec);
+    if(ec) {
+      WSR_LOG(LOG_ERROR, "Send Error: " + ec.message());
+    }
+  }
+  /* Backlog left, try again once the socket had time to write; timers of the connection run on its strand */
+  using websocketpp::lib::placeholders::_1;
+  using websocketpp::lib::bind;
+  con->set_timer(LANE_RETRY, bind(&WebsocketConnection::drainHandler,this,::_1));
+}
+
+
+void WebsocketConnection::drainHandler(websocketpp::lib::error_code const & ec) {
+  if(ec) {
+    websocket_lock guard(this->lane_mutex);
+    this->drain_pending = false;
+    return;
+  }
+  this->drainLanes();
+}
+
+
+/* Weighted round robin over the lanes, a lane without frames gives its turn away */
+bool WebsocketConnection::nextFrame(std::string & payload) {
+  if(this->control_lane.empty() && this->bulk_lane.empty()) {
+    return false;
+  }
+  unsigned int round = this->control_share + this->bulk_share;
+  bool control = this->bulk_lane.empty() || (!this->control_lane.empty() && (round == 0 || this->lane_turn < this->control_share));
+  this->lane_turn = round == 0 ? 0 : (this->lane_turn + 1) % round;
+  std::deque<std::string> & lane = control ? this->control_lane : this->bulk_lane;
+  payload.swap(lane.front());
+  lane.pop_front();
+  if(control) {
+    this->lane_stats.control_sent++;
+  } else {
+    this->lane_stats.bulk_sent++;
+  }
+  return true;
+}
+
+
+void WebsocketConnection::pong(time_point received) {
+  this->send(this->codec->getPongFrame(), LANE_CONTROL);
+  long latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - received).count();
+  websocket_lock guard(this->stats_mutex);
+  HeartbeatStats & stats = this->heartbeat_stats;
+  if(stats.pings > 0) {
+    long interval = std::chrono::duration_cast<std::chrono::microseconds>(received - this->last_ping).count();
+    this->interval_total += interval;
+    stats.interval_last = interval;
+    stats.interval_min = stats.pings == 1 || interval < stats.interval_min ? interval : stats.interval_min;
+    stats.interval_max = interval > stats.interval_max ? interval : stats.interval_max;
+    stats.interval_avg = this->interval_total / static_cast<long>(stats.pings);
+  }
+  this->last_ping = received;
+  this->latency_total += latency;
+  stats.pings++;
+  stats.latency_last = latency;
+  stats.latency_max = latency > stats.latency_max ? latency : stats.latency_max;
+  stats.latency_avg = this->latency_total / static_cast<long>(stats.pings);
+}
+
+
+/* Queue handler on the strand of the connection, where websocketpp runs the handlers of the connection */
+void WebsocketConnection::postHandler(boost::function<void()> handler) {
+  websocketpp::lib::error_code ec;
+  client::connection_ptr con = this->ws_client.get_con_from_hdl(this->ws_hdl, ec);
+  if(!ec && con->get_strand()) {
+    con->get_strand()->post(handler);
+  } else {
+    this->ws_client.get_io_service().post(handler);
+  }
+}
+
+
+/* Run handler on the strand of the connection, right away if the caller already runs on it */
+void WebsocketConnection::dispatchHandler(boost::function<void()> handler) {
   websocketpp::lib::error_code ec;
-  this->ws_client.send(this->ws_hdl, event.serialize(), websocketpp::frame::opcode::text, ec);
+  client::connection_ptr con = this->ws_client.get_con_from_hdl(this->ws_hdl, ec);
+  if(!ec && con->get_strand()) {
+    con->get_strand()->dispatch(handler);
+  } else {
+    this->ws_client.get_io_service().dispatch(handler);
+  }
+}
+
+
+/* Housekeeping every TICK_INTERVAL while the connection is open: an entry on the timer wheel of the
+   reactor, a timer of the connection otherwise. Either way tickHandler runs on the strand */
+void WebsocketConnection::startTicker() {
+  this->ticking = true;
+  if(this->dispatcher->getReactor() != NULL) {
+    this->tick_id = this->dispatcher->getReactor()->getTimerWheel().add(boost::bind(&WebsocketConnection::tick, this));
+    return;
+  }
+  websocketpp::lib::error_code ec;
+  client::connection_ptr con = this->ws_client.get_con_from_hdl(this->ws_hdl, ec);
   if(ec) {
-    this->ws_client.get_alog().write(websocketpp::log::alevel::app,
-    "Send Error: " + ec.message());
+    this->ticking = false;
+    return;
   }
+  using websocketpp::lib::placeholders::_1;
+  using websocketpp::lib::bind;
+  this->ticker = con->set_timer(TICK_INTERVAL, bind(&WebsocketConnection::tickHandler,this,::_1));
+}
+
+
+/* Off the wheel at once; a timer of the connection is cancelled and its handler clears ticking */
+void WebsocketConnection::stopTicker() {
+  if(this->tick_id != 0) {
+    this->dispatcher->getReactor()->getTimerWheel().remove(this->tick_id);
+    this->tick_id = 0;
+    this->ticking = false;
+  }
+  if(this->ticker) {
+    this->ticker->cancel();
+  }
+}
+
+
+/* Called by the timer wheel with the wheel locked, a tick still waiting on the strand is not doubled */
+void WebsocketConnection::tick() {
+  if(!this->tick_pending.exchange(true)) {
+    this->postHandler(boost::bind(&WebsocketConnection::tickHandler, this, websocketpp::lib::error_code()));
+  }
+}
+
+
+void WebsocketConnection::tickHandler(websocketpp::lib::error_code const & ec) {
+  time_point now = std::chrono::steady_clock::now();
+  if(ec || this->closed) {
+    this->stopTicker();
+    this->ticking = false;
+  } else if(this->monitor.expired(now)) {
+    this->stopTicker();
+    this->ticking = false;
+    this->heartbeatLost();
+  } else {
+    if(this->monitor.probe(now)) {
+      websocketpp::lib::error_code ping_ec;
+      this->ws_client.ping(this->ws_hdl, "", ping_ec);
+    }
+    if(this->tick_id == 0) {
+      this->startTicker();
+    }
+  }
+  this->tick_pending = false;
+}
+
+
+/* A websocket pong, the answer to a probe of the heartbeat monitor */
+void WebsocketConnection::pongHandler(websocketpp::connection_hdl /* hdl */, std::string /* payload */) {
+  this->monitor.pong(std::chrono::steady_clock::now());
+}
+
+
+void WebsocketConnection::abortHandler() {
+  websocketpp::lib::error_code ec;
+  client::connection_ptr con = this->ws_client.get_con_from_hdl(this->ws_hdl, ec);
+  if(ec) {
+    return;
+  }
+  boost::system::error_code close_ec;
+  con->get_raw_socket().close(close_ec);
+}
+
+
+/* Drop a connection that missed its heartbeat deadlines. A close handshake would wait on the dead peer,
+   closing the socket fails the pending read and websocketpp runs the close handler right away */
+void WebsocketConnection::heartbeatLost() {
+  LivenessStats stats = this->monitor.getStats();
+  WSR_LOG(LOG_WARN, "Heartbeat lost after " + boost::lexical_cast<std::string>(stats.silence / 1000) + " ms of silence, dropping connection!");
+  this->abortHandler();
 }
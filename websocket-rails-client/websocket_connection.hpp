@@ -27,9 +27,65 @@
 
 #include "websocket.hpp"
 #include "event.hpp"
+#include "frame_arena.hpp"
+#include "frame_event.hpp"
+#include "wire_codec.hpp"
+#include "pooled_message_manager.hpp"
+#include "heartbeat_monitor.hpp"
 
 class WebsocketRails;
 
+/**
+ *  Heartbeat statistics of a connection, times in microseconds.
+ **/
+struct HeartbeatStats {
+  HeartbeatStats() : pings(0), interval_last(0), interval_min(0), interval_max(0), interval_avg(0), latency_last(0), latency_max(0), latency_avg(0) {}
+  unsigned long pings;          /* Pings answered                       */
+  long interval_last;           /* Time between the last two pings      */
+  long interval_min;
+  long interval_max;
+  long interval_avg;
+  long latency_last;            /* Time from ping arrival to pong sent  */
+  long latency_max;
+  long latency_avg;
+};
+
+/**
+ *  Socket and IO thread tuning of a connection.
+ **/
+struct LatencyProfile {
+  LatencyProfile() : tcp_nodelay(false), send_buffer(0), receive_buffer(0), busy_poll(0), cpu(-1), spin(false) {}
+  static LatencyProfile lowLatency() {
+    LatencyProfile profile;
+    profile.tcp_nodelay = true;
+    profile.busy_poll = 50;
+    return profile;
+  }
+  bool tcp_nodelay;             /* Disable Nagle's algorithm                                     */
+  int send_buffer;              /* SO_SNDBUF in bytes, 0 keeps the system default                */
+  int receive_buffer;           /* SO_RCVBUF in bytes, 0 keeps the system default                */
+  int busy_poll;                /* SO_BUSY_POLL in microseconds (Linux), 0 to leave it off       */
+  int cpu;                      /* Pin the IO thread to this CPU (Linux), -1 to leave it floating */
+  bool spin;                    /* Spin on poll() instead of blocking in epoll                   */
+};
+
+/* Outbound priority lanes, control frames go ahead of bulk data */
+enum OutboundLane {
+  LANE_CONTROL,     /* Pongs and websocket_rails.* events (subscribe, unsubscribe, channel token) */
+  LANE_BULK         /* Application events                                                        */
+};
+
+/**
+ *  Outbound lane counters.
+ **/
+struct LaneStats {
+  LaneStats() : control_queued(0), bulk_queued(0), control_sent(0), bulk_sent(0) {}
+  std::size_t control_queued;   /* Frames waiting in the lane */
+  std::size_t bulk_queued;
+  unsigned long control_sent;
+  unsigned long bulk_sent;
+};
+
 class WebsocketConnection {
 public:
 
@@ -37,8 +93,10 @@ public:
    *  Type Definitions and Variables
    **/
   typedef websocketpp::lib::lock_guard<websocketpp::lib::mutex> websocket_lock;
-  typedef websocketpp::client<websocketpp::config::asio_client> client;
-  typedef websocketpp::config::asio_client::message_type::ptr message_ptr;
+  typedef websocketpp::client<PooledClientConfig> client;
+  typedef PooledClientConfig::message_type::ptr message_ptr;
+  typedef PooledClientConfig::con_msg_manager_type message_manager;
+  typedef std::chrono::steady_clock::time_point time_point;
   websocketpp::lib::mutex ws_mutex;
   static const std::string connection_type;
 
@@ -46,16 +104,32 @@ public:
    *  Constructor
    **/
   WebsocketConnection(std::string url, WebsocketRails & dispatcher);
+  ~WebsocketConnection();
 
   /**
    *  Functions
    **/
+  bool start();
   void run();
+  bool isClosed();
+  bool isIdle();
   void close();
   void trigger(Event event);
+  void pong();
+  HeartbeatStats getHeartbeatStats();
+  LivenessStats getLivenessStats();
+  bool isAlive();
+  bool isIoThread();
+  void setLaneShares(unsigned int control_share, unsigned int bulk_share);
+  LaneStats getLaneStats();
+  MessagePoolStats getMessagePoolStats();
   std::string setConnectionId(std::string connection_id);
   std::string getConnectionId();
+  std::string getUrl();
+  void abort();
   std::queue<Event> flushQueue();
+  std::queue<Event> takeQueue();
+  void restoreQueue(std::queue<Event> queued);
 
 private:
 
@@ -67,17 +141,60 @@ private:
   WebsocketRails * dispatcher;
   std::queue<Event> empty;
   std::queue<Event> event_queue;
+  websocketpp::lib::mutex queue_mutex;
   websocketpp::connection_hdl ws_hdl;
   client ws_client;
+  FrameArena frame_arena;
+  websocketpp::lib::mutex stats_mutex;
+  HeartbeatStats heartbeat_stats;
+  time_point last_ping;
+  long interval_total;
+  long latency_total;
+  client::timer_ptr ticker;                 /* Housekeeping timer, NULL on a reactor */
+  std::size_t tick_id;                      /* Entry on the timer wheel of the reactor, 0 if none */
+  boost::atomic<bool> closed;
+  boost::atomic<bool> aborted;
+  boost::atomic<bool> ticking;
+  boost::atomic<bool> tick_pending;         /* A tick of the wheel is posted to the strand */
+  boost::thread::id io_thread;
+  websocketpp::lib::mutex lane_mutex;
+  std::deque<std::string> control_lane;
+  std::deque<std::string> bulk_lane;
+  unsigned int control_share;
+  unsigned int bulk_share;
+  unsigned int lane_turn;
+  bool drain_pending;
+  LaneStats lane_stats;
+  LatencyProfile latency_profile;
+  boost::shared_ptr<WireCodec> codec;
+  boost::shared_ptr<MessagePool> message_pool;         /* Payload buffers of inbound and outbound frames */
+  websocketpp::lib::shared_ptr<message_manager> messages;   /* Wraps outbound frames into pooled messages */
+  HeartbeatMonitor monitor;
 
   /**
    *  Functions
    **/
   void openHandler(websocketpp::connection_hdl hdl);
+  void socketHandler(websocketpp::connection_hdl hdl);
+  void pinThread();
   void closeHandler(websocketpp::connection_hdl hdl);
   void failHandler(websocketpp::connection_hdl hdl);
   void messageHandler(websocketpp::connection_hdl hdl, message_ptr msg);
+  void pongHandler(websocketpp::connection_hdl hdl, std::string payload);
+  void heartbeatLost();
+  void abortHandler();
   void sendEvent(Event event);
+  void postHandler(boost::function<void()> handler);
+  void dispatchHandler(boost::function<void()> handler);
+  void startTicker();
+  void stopTicker();
+  void tick();
+  void tickHandler(websocketpp::lib::error_code const & ec);
+  void pong(time_point received);
+  void send(std::string payload, OutboundLane lane);
+  void drainLanes();
+  void drainHandler(websocketpp::lib::error_code const & ec);
+  bool nextFrame(std::string & payload);
 
 };
 
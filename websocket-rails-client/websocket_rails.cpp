@@ -23,6 +23,7 @@
  */
 
 #include "websocket_rails.hpp"
+#include <algorithm>
 
 
 
@@ -30,7 +31,21 @@
  *  Constructors                    *
  ************************************/
 
-WebsocketRails::WebsocketRails(std::string url) : url(url), conn() {}
+WebsocketRails::WebsocketRails(std::string url) : url(url), frame_arena_size(FRAME_ARENA_BLOCK), io_service(), reactor(), control_share(LANE_CONTROL_SHARE), bulk_share(LANE_BULK_SHARE), wire_format(WIRE_JSON), race_stagger(RACE_STAGGER), race_winner(), channel_queue(boost::make_shared<const map_channel>()), conn(NULL), deadlines(this->io_service, boost::bind(&WebsocketRails::expireEvents, this)) {
+  this->endpoints.add(url);
+}
+
+
+/* Attach to a loop run by the caller, no threads are started */
+WebsocketRails::WebsocketRails(std::string url, boost::asio::io_service & io_service) : url(url), frame_arena_size(FRAME_ARENA_BLOCK), io_service(&io_service), reactor(), control_share(LANE_CONTROL_SHARE), bulk_share(LANE_BULK_SHARE), wire_format(WIRE_JSON), race_stagger(RACE_STAGGER), race_winner(), channel_queue(boost::make_shared<const map_channel>()), conn(NULL), deadlines(this->io_service, boost::bind(&WebsocketRails::expireEvents, this)) {
+  this->endpoints.add(url);
+}
+
+
+/* Run on the thread pool of a reactor shared with other dispatchers */
+WebsocketRails::WebsocketRails(std::string url, Reactor & reactor) : url(url), frame_arena_size(FRAME_ARENA_BLOCK), io_service(&reactor.getIoService()), reactor(&reactor), control_share(LANE_CONTROL_SHARE), bulk_share(LANE_BULK_SHARE), wire_format(WIRE_JSON), race_stagger(RACE_STAGGER), race_winner(), channel_queue(boost::make_shared<const map_channel>()), conn(NULL), deadlines(this->io_service, boost::bind(&WebsocketRails::expireEvents, this)) {
+  this->endpoints.add(url);
+}
 
 
 
@@ -38,67 +53,269 @@ WebsocketRails::WebsocketRails(std::string url) : url(url), conn() {}
  *  Connection functions            *
  ************************************/
 
+/* Connect to the best endpoint that answers first, see race() */
 std::string WebsocketRails::connect() {
-  this->state = "connecting";
-  this->setConn(new WebsocketConnection(this->url, *this));
-  this->websocket_connection_thread = boost::thread(&WebsocketConnection::run, this->getConn());
-  int count = 0;
-  while(!this->isConnected()) {
-    boost::posix_time::seconds workTime(1);
-    boost::this_thread::sleep(workTime);
-    count++;
-    if(count == TIMEOUT_CONN) {
-      return this->disconnect();
-    }
+  if(!this->state.transition(STATE_CONNECTING)) {
+    return this->getState();
+  }
+  if(this->race()) {
+    this->connectionEstablished(this->race_data);
   }
-  return this->state;
+  return this->isConnected() ? this->getState() : this->disconnect();
 }
 
 
 std::string WebsocketRails::disconnect() {
-  if(this->getConn() != NULL) {
-    if(this->isConnected()) {
-      this->getConn()->close();
-    }
-    this->websocket_connection_thread.interrupt();
-    this->websocket_connection_thread.join();
-    delete this->getConn();
-    this->setConn(NULL);
-  }
-  return this->state = "disconnected";
+  bool open = this->isConnected();
+  this->state.transition(STATE_CLOSING);
+  this->closeConnection(open);
+  this->reapAttempts(true);
+  this->state.transition(STATE_DISCONNECTED);
+  return this->getState();
 }
 
 
 void WebsocketRails::reconnect() {
   std::string oldconnection_id = this->getConn() != NULL ? this->getConn()->getConnectionId() : "";
-  this->disconnect();
+  bool open = this->isConnected();
+  if(!this->state.transition(STATE_RECONNECTING)) {
+    return;
+  }
+  this->closeConnection(open);
   if(this->connect() == "connected") {
-    for(auto& x: this->event_queue) {
-        Event event = x.second;
-        if(event.getConnectionId() == oldconnection_id && !event.isResult()) {
-          this->triggerEvent(event);
+    std::vector<Event> events;
+    {
+      boost::lock_guard<boost::mutex> guard(this->event_queue_mutex);
+      for(auto& x: this->event_queue) {
+        Event event = x.second.getEvent();
+        if(event.getConnectionId() == oldconnection_id) {
+          events.push_back(event);
         }
+      }
+    }
+    for(std::vector<Event>::iterator it = events.begin(); it != events.end(); ++it) {
+      this->triggerEvent(*it);
     }
     this->reconnectChannels();
   }
 }
 
 
+/* Snapshot of the session for a handover: channels with their tokens and the events not sent yet.
+   The unsent events move into the snapshot, their failure callbacks get {"error": "handed over"} */
+std::string WebsocketRails::exportSession() {
+  SessionExport session = this->takeSession();
+  this->commitSession(session);
+  return session.snapshot;
+}
+
+
+/* Take the session out for a handover without telling anyone yet, see commitSession and restoreSession */
+SessionExport WebsocketRails::takeSession() {
+  SessionExport session;
+  jsonxx::Object snapshot;
+  jsonxx::Array channels;
+  jsonxx::Array events;
+  boost::shared_ptr<const map_channel> channels_now = this->loadChannels();
+  for(auto& x: *channels_now) {
+    Channel & channel = *x.second;
+    jsonxx::Object entry;
+    entry << "name" << channel.getName();
+    entry << "private" << channel.isPrivate();
+    entry << "token" << channel.getToken();
+    channels << entry;
+    std::queue<Event> queued = channel.takeQueue();
+    for(std::queue<Event> copy = queued; !copy.empty(); copy.pop()) {
+      events << copy.front().serialize();
+    }
+    session.channel_queues.push_back(std::make_pair(channel.getName(), queued));
+  }
+  if(this->getConn() != NULL) {
+    session.connection_queue = this->getConn()->takeQueue();
+    for(std::queue<Event> copy = session.connection_queue; !copy.empty(); copy.pop()) {
+      /* Subscriptions are made again from the channel list */
+      if(copy.front().getName().compare(0, 16, "websocket_rails.") != 0) {
+        events << copy.front().serialize();
+      }
+    }
+  }
+  session.waiting = this->window.takeWaiting();
+  for(std::vector<PendingEvent>::iterator it = session.waiting.begin(); it != session.waiting.end(); ++it) {
+    events << it->getEvent().serialize();
+  }
+  snapshot << "url" << this->url;
+  snapshot << "connection_id" << (this->getConn() != NULL ? this->getConn()->getConnectionId() : "");
+  snapshot << "channels" << channels;
+  snapshot << "events" << events;
+  session.snapshot = snapshot.json();
+  return session;
+}
+
+
+/* The handover went through: the events taken now belong to the other process, their failure callbacks get
+   {"error": "handed over"} */
+void WebsocketRails::commitSession(SessionExport & session) {
+  for(; !session.connection_queue.empty(); session.connection_queue.pop()) {
+    this->failEvent(session.connection_queue.front().getEventId(), "handed over");
+  }
+  for(std::vector<PendingEvent>::iterator it = session.waiting.begin(); it != session.waiting.end(); ++it) {
+    it->runCallbacks(false, jsonxx::Object("error", "handed over"));
+  }
+  session.waiting.clear();
+  session.channel_queues.clear();
+}
+
+
+/* The handover failed: put the events taken back ahead of the ones queued since, with their callbacks */
+void WebsocketRails::restoreSession(SessionExport & session) {
+  boost::shared_ptr<const map_channel> channels = this->loadChannels();
+  for(std::size_t i = 0; i < session.channel_queues.size(); i++) {
+    map_channel::const_iterator found = channels->find(session.channel_queues[i].first);
+    if(found != channels->end()) {
+      found->second->restoreQueue(session.channel_queues[i].second);
+    }
+  }
+  session.channel_queues.clear();
+  /* Without a connection they stay pending and are sent again by the next reconnect */
+  if(this->getConn() != NULL) {
+    this->getConn()->restoreQueue(session.connection_queue);
+  }
+  session.connection_queue = std::queue<Event>();
+  std::vector<PendingEvent> admitted = this->window.restoreWaiting(session.waiting);
+  for(std::vector<PendingEvent>::iterator it = admitted.begin(); it != admitted.end(); ++it) {
+    this->sendPending(*it);
+  }
+  session.waiting.clear();
+  this->armDeadlines();
+}
+
+
+/* Take over a session snapshot: subscribe its channels with their tokens and trigger its events */
+bool WebsocketRails::importSession(std::string snapshot) {
+  return this->importChannels(snapshot) && this->importEvents(snapshot);
+}
+
+
+/* Subscribe the channels of a session snapshot with their tokens */
+bool WebsocketRails::importChannels(std::string snapshot) {
+  jsonxx::Object session;
+  if(!session.parse(snapshot)) {
+    return false;
+  }
+  if(session.has<jsonxx::Array>("channels")) {
+    jsonxx::Array & channels = session.get<jsonxx::Array>("channels");
+    for(std::size_t i = 0; i < channels.size(); i++) {
+      if(!channels.has<jsonxx::Object>(i)) {
+        continue;
+      }
+      jsonxx::Object & entry = channels.get<jsonxx::Object>(i);
+      std::string name = entry.get<jsonxx::String>("name", "");
+      bool is_private = entry.get<jsonxx::Boolean>("private", false);
+      std::string token = entry.get<jsonxx::String>("token", "");
+      Channel * channel = is_private ? this->subscribePrivate(name) : this->subscribe(name);
+      if(!token.empty()) {
+        channel->setToken(token);
+      }
+    }
+  }
+  return true;
+}
+
+
+/* Trigger the events of a session snapshot */
+bool WebsocketRails::importEvents(std::string snapshot) {
+  jsonxx::Object session;
+  if(!session.parse(snapshot)) {
+    return false;
+  }
+  if(session.has<jsonxx::Array>("events")) {
+    jsonxx::Array & events = session.get<jsonxx::Array>("events");
+    for(std::size_t i = 0; i < events.size(); i++) {
+      jsonxx::Array data;
+      if(events.has<jsonxx::String>(i) && data.parse(events.get<jsonxx::String>(i))) {
+        this->triggerEvent(Event(data));
+      }
+    }
+  }
+  return true;
+}
+
+
+/* Wait until the results of all events sent arrived or the time is up */
+bool WebsocketRails::drain(long seconds) {
+  return this->waitFor(boost::bind(&WebsocketRails::pendingDone, this), seconds);
+}
+
+
+/* Run the ready handlers of the attached loop without blocking, returns the number run */
+std::size_t WebsocketRails::poll() {
+  if(this->io_service == NULL || this->reactor != NULL) {
+    return 0;
+  }
+  if(this->io_service->stopped()) {
+    this->io_service->restart();
+  }
+  return this->io_service->poll();
+}
+
+
+/* Run handlers of the attached loop for up to the given time, returns the number run */
+std::size_t WebsocketRails::runFor(long milliseconds) {
+  if(this->io_service == NULL || this->reactor != NULL) {
+    return 0;
+  }
+  if(this->io_service->stopped()) {
+    this->io_service->restart();
+  }
+  return this->io_service->run_for(std::chrono::milliseconds(milliseconds));
+}
+
+
+/* Get the caller-owned loop, NULL if the connection runs on a thread of its own */
+boost::asio::io_service * WebsocketRails::getIoService() {
+  return this->io_service;
+}
+
+
+/* Get the reactor the dispatcher runs on, or NULL */
+Reactor * WebsocketRails::getReactor() {
+  return this->reactor;
+}
+
+
 /* Get Connection State */
 std::string WebsocketRails::getState() {
-  return this->state;
+  return ConnectionStateMachine::toString(this->state.get());
+}
+
+
+/* Get Connection State without a string, safe from any thread */
+ConnectionState WebsocketRails::getConnectionState() {
+  return this->state.get();
 }
 
 
-/* Set Connection State */
-std::string WebsocketRails::setState(std::string state) {
-  return this->state = state;
+/* Move the connection to a state, false if that transition is not allowed from the current state */
+bool WebsocketRails::setState(ConnectionState state) {
+  return this->state.transition(state);
+}
+
+
+/* Move the connection to a state only from the expected one */
+bool WebsocketRails::setState(ConnectionState from, ConnectionState to) {
+  return this->state.transition(from, to);
+}
+
+
+/* Observe state transitions, the callback runs on the thread making the transition */
+void WebsocketRails::onStateChange(state_cb_func callback) {
+  this->state.onTransition(callback);
 }
 
 
 /* Get Connection Object */
 WebsocketConnection * WebsocketRails::getConn() {
-  return this->conn;
+  return this->conn.load(boost::memory_order_acquire);
 }
 
 
@@ -107,20 +324,203 @@ bool WebsocketRails::isConnected() {
 }
 
 
+/* Get the ping interval and pong latency statistics of the connection */
+HeartbeatStats WebsocketRails::getHeartbeatStats() {
+  return this->getConn() != NULL ? this->getConn()->getHeartbeatStats() : HeartbeatStats();
+}
+
+
+/* Set the block size of the inbound frame arena, 0 returns its memory after every frame */
+void WebsocketRails::setFrameArenaSize(std::size_t block_size) {
+  this->frame_arena_size = block_size;
+}
+
+
+/* Get the block size of the inbound frame arena */
+std::size_t WebsocketRails::getFrameArenaSize() {
+  return this->frame_arena_size;
+}
+
+
+/* Frames sent from the control and bulk lanes per round when both have a backlog */
+void WebsocketRails::setLaneShares(unsigned int control_share, unsigned int bulk_share) {
+  this->control_share = control_share;
+  this->bulk_share = bulk_share;
+  if(this->getConn() != NULL) {
+    this->getConn()->setLaneShares(control_share, bulk_share);
+  }
+}
+
+
+unsigned int WebsocketRails::getControlShare() {
+  return this->control_share;
+}
+
+
+unsigned int WebsocketRails::getBulkShare() {
+  return this->bulk_share;
+}
+
+
+/* Socket options and IO thread tuning, applied to the next connection */
+void WebsocketRails::setLatencyProfile(LatencyProfile profile) {
+  this->latency_profile = profile;
+}
+
+
+LatencyProfile WebsocketRails::getLatencyProfile() {
+  return this->latency_profile;
+}
+
+
+/* Deadlines after which a silent connection is dropped, applied to the next connection */
+void WebsocketRails::setHeartbeatPolicy(HeartbeatPolicy policy) {
+  this->heartbeat_policy = policy;
+}
+
+
+HeartbeatPolicy WebsocketRails::getHeartbeatPolicy() {
+  return this->heartbeat_policy;
+}
+
+
+LivenessStats WebsocketRails::getLivenessStats() {
+  return this->getConn() != NULL ? this->getConn()->getLivenessStats() : LivenessStats();
+}
+
+
+/* Encoding asked for on the next connection, the server may decline it in favour of JSON */
+void WebsocketRails::setWireFormat(WireFormat format) {
+  this->wire_format = format;
+}
+
+
+WireFormat WebsocketRails::getWireFormat() {
+  return this->wire_format;
+}
+
+
+/* Drop inbound events whose id and channel were seen among the last capacity events within max_age
+   milliseconds (0 for no age bound); a capacity of 0 turns de-duplication off. Set before connect(). */
+void WebsocketRails::setDedupWindow(std::size_t capacity, long max_age) {
+  if(capacity == 0) {
+    this->dedup.reset();
+  } else {
+    this->dedup = boost::make_shared<DedupWindow>(capacity, max_age);
+  }
+}
+
+
+DedupStats WebsocketRails::getDedupStats() {
+  return this->dedup ? this->dedup->getStats() : DedupStats();
+}
+
+
+/* Time every callback per binding, set before connect() */
+void WebsocketRails::setProfiling(bool enabled) {
+  if(!enabled) {
+    this->profiler.reset();
+  } else if(!this->profiler) {
+    this->profiler = boost::make_shared<CallbackProfiler>();
+  }
+}
+
+
+/* Get the callback profiler, NULL unless profiling is on */
+CallbackProfiler * WebsocketRails::getProfiler() {
+  return this->profiler.get();
+}
+
+
+/* The profiler for the conflated deliveries, they hold on to it on the delivery thread */
+boost::shared_ptr<CallbackProfiler> WebsocketRails::shareProfiler() {
+  return this->profiler;
+}
+
+
+/* The delivery thread shared by the conflated channels, created with the first of them */
+boost::shared_ptr<DeliveryExecutor> WebsocketRails::getDeliveryExecutor() {
+  boost::shared_ptr<DeliveryExecutor> executor = boost::atomic_load(&this->delivery);
+  if(!executor) {
+    boost::shared_ptr<DeliveryExecutor> created = boost::make_shared<DeliveryExecutor>();
+    executor = boost::atomic_compare_exchange(&this->delivery, &executor, created) ? created : executor;
+  }
+  return executor;
+}
+
+
+/* Another endpoint of the same server, connect() races them and reconnect() fails over between them */
+void WebsocketRails::addEndpoint(std::string url) {
+  this->endpoints.add(url);
+}
+
+
+/* Url of the current connection, empty if there is none */
+std::string WebsocketRails::getEndpoint() {
+  return this->getConn() != NULL ? this->getConn()->getUrl() : "";
+}
+
+
+vec_endpoint_stats WebsocketRails::getEndpointStats() {
+  return this->endpoints.getStats();
+}
+
+
+/* Head start of each endpoint in a connect race over the next one, 0 starts them all at once */
+void WebsocketRails::setRaceStagger(long milliseconds) {
+  this->race_stagger = milliseconds;
+}
+
+
+long WebsocketRails::getRaceStagger() {
+  return this->race_stagger;
+}
+
+
+/* Get the outbound lane counters of the connection */
+LaneStats WebsocketRails::getLaneStats() {
+  return this->getConn() != NULL ? this->getConn()->getLaneStats() : LaneStats();
+}
+
+
+/* Buffer reuse of the frames of the current connection */
+MessagePoolStats WebsocketRails::getMessagePoolStats() {
+  return this->getConn() != NULL ? this->getConn()->getMessagePoolStats() : MessagePoolStats();
+}
+
+
 
 /************************************
  *  Connection callbacks            *
  ************************************/
 
-void WebsocketRails::newMessage(jsonxx::Array data) {
-  for(int _i = 0, _len = data.size(); _i < _len; _i++) {
-    jsonxx::Array socket_message = data.get<jsonxx::Array>(_i);
-    Event event(socket_message);
+void WebsocketRails::newMessage(vec_frame_event & data) {
+  for(vec_frame_event::iterator it = data.begin(); it != data.end(); ++it) {
+    FrameEvent & event = *it;
+    /* Results and events replayed around a reconnect are dropped before anything is parsed */
+    if(this->dedup && !event.getId().empty() && !event.isPing() && this->dedup->seen(event)) {
+      continue;
+    }
     if(event.isResult()) {
-      if(this->event_queue.find(event.getId()) != this->event_queue.end()) {
-        this->event_queue[event.getId()].runCallbacks(event.getSuccess(), event.getData());
+      EventId id;
+      if(EventId::parse(event.getId().ptr, event.getId().len, id)) {
+        boost::unique_lock<boost::mutex> lock(this->event_queue_mutex);
+        std::tr1::unordered_map<EventId, PendingEvent, EventIdHash>::iterator found = this->event_queue.find(id);
+        if(found != this->event_queue.end()) {
+          PendingEvent pending = found->second;
+          this->event_queue.erase(found);
+          lock.unlock();
+          this->releaseWindow(pending);
+          if(pending.hasCallback(event.getSuccess()) && this->profiler) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            pending.runCallbacks(event.getSuccess(), event.getData());
+            long micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            this->profiler->record("results", event.getName().str(), event.getSuccess() ? "success" : "failure", micros);
+          } else if(pending.hasCallback(event.getSuccess())) {
+            pending.runCallbacks(event.getSuccess(), event.getData());
+          }
+        }
       }
-      this->event_queue.erase(event.getId());
     } else if(event.isChannel()) {
       this->dispatchChannel(event);
     } else if(event.isPing()) {
@@ -128,34 +528,60 @@ void WebsocketRails::newMessage(jsonxx::Array data) {
     } else {
       this->dispatch(event);
     }
-    if(this->state == "connecting" && event.getName() == "client_connected") {
-      this->connectionEstablished(event.getData());
+  }
+}
+
+
+/* Messages of a connect race candidate. The first one to deliver client_connected becomes the connection right here
+   on its IO thread, so the frames behind client_connected in the batch and all later ones go through newMessage */
+void WebsocketRails::candidateMessage(WebsocketConnection * conn, vec_frame_event & data) {
+  for(vec_frame_event::iterator it = data.begin(); it != data.end(); ++it) {
+    if(it->getName() == "client_connected") {
+      {
+        boost::lock_guard<boost::mutex> guard(this->race_mutex);
+        if(this->race_winner != NULL || std::find(this->candidates.begin(), this->candidates.end(), conn) == this->candidates.end()) {
+          return;
+        }
+        this->race_winner = conn;
+        this->race_data = it->getData();
+        conn->setConnectionId(this->race_data.get<jsonxx::String>("connection_id"));
+        this->setConn(conn);
+      }
+      data.erase(data.begin(), it + 1);
+      this->newMessage(data);
+      return;
     }
   }
 }
 
 
+/* The current connection was lost, its endpoint ranks lower in the next race */
+void WebsocketRails::endpointFailed(std::string url) {
+  this->endpoints.failed(url);
+}
+
+
 void WebsocketRails::onOpen(cb_func callback) {
-  this->on_open_callback = callback;
+  this->on_open_callback = std::move(callback);
 }
 
 
 void WebsocketRails::onClose(cb_func callback) {
-  this->on_close_callback = callback;
+  this->on_close_callback = std::move(callback);
 }
 
 
 void WebsocketRails::onFail(cb_func callback) {
-  this->on_fail_callback = callback;
+  this->on_fail_callback = std::move(callback);
 }
 
 
-cb_func WebsocketRails::getOnCloseCallback() {
+const cb_func & WebsocketRails::getOnCloseCallback() {
   return this->on_close_callback;
 }
 
 
-cb_func WebsocketRails::getOnFailCallback() {
+const cb_func & WebsocketRails::getOnFailCallback() {
   return this->on_fail_callback;
 }
 
@@ -165,19 +591,31 @@ cb_func WebsocketRails::getOnFailCallback() {
  *  Event functions                 *
  ************************************/
 
+/* Safe from any thread, dispatch sees the new binding from the next event on */
 void WebsocketRails::bind(std::string event_name, cb_func callback) {
-  if(this->callbacks.find(event_name) == this->callbacks.end()) {
-    vec_cb_func v;
-    this->callbacks[event_name] = v;
-  }
-  this->callbacks[event_name].push_back(callback);
+  this->bind(event_name, std::move(callback), "");
+}
+
+
+/* Bind with a label the profiler reports the callback under */
+void WebsocketRails::bind(std::string event_name, cb_func callback, std::string label) {
+  this->callbacks.bind(event_name, boost::make_shared<const Binding>(std::move(callback), label));
+}
+
+
+/* Bind a callback that only gets the events its filter matches, non-matching events are never parsed */
+void WebsocketRails::bind(std::string event_name, EventFilter filter, cb_func callback) {
+  this->bind(event_name, filter, std::move(callback), "");
+}
+
+
+void WebsocketRails::bind(std::string event_name, EventFilter filter, cb_func callback, std::string label) {
+  this->callbacks.bind(event_name, filter, boost::make_shared<const Binding>(std::move(callback), label));
 }
 
 
 void WebsocketRails::unbindAll(std::string event_name) {
-  if(this->callbacks.find(event_name) != this->callbacks.end()) {
-    this->callbacks.erase(event_name);
-  }
+  this->callbacks.unbindAll(event_name);
 }
 
 
@@ -192,18 +630,106 @@ void WebsocketRails::trigger(std::string event_name, jsonxx::Object event_data)
 void WebsocketRails::trigger(std::string event_name, jsonxx::Object event_data, cb_func success_callback, cb_func failure_callback) {
   jsonxx::Array data;
   data << event_name << event_data << (this->getConn() != NULL ? this->getConn()->getConnectionId() : "");
-  Event event(data, success_callback, failure_callback);
-  this->triggerEvent(event);
+  Event event(data);
+  this->triggerWindowed(event, std::move(success_callback), std::move(failure_callback), 0);
+}
+
+
+/* Trigger with callbacks, the failure callback gets {"error": "timeout"} if there is no result after timeout milliseconds */
+void WebsocketRails::trigger(std::string event_name, jsonxx::Object event_data, cb_func success_callback, cb_func failure_callback, long timeout) {
+  jsonxx::Array data;
+  data << event_name << event_data << (this->getConn() != NULL ? this->getConn()->getConnectionId() : "");
+  Event event(data);
+  this->triggerWindowed(event, std::move(success_callback), std::move(failure_callback), timeout);
 }
 
 
 void WebsocketRails::triggerEvent(Event event) {
-  if(this->event_queue.find(event.getId()) == this->event_queue.end()) {
-    this->event_queue[event.getId()] = event;
+  this->triggerEvent(event, cb_func(), cb_func(), 0);
+}
+
+
+void WebsocketRails::triggerEvent(Event event, cb_func success_callback, cb_func failure_callback) {
+  this->triggerEvent(event, std::move(success_callback), std::move(failure_callback), 0);
+}
+
+
+void WebsocketRails::triggerEvent(Event event, cb_func success_callback, cb_func failure_callback, long timeout) {
+  PendingEvent pending(event, std::move(success_callback), std::move(failure_callback));
+  if(timeout > 0) {
+    pending.setDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout));
   }
-  if(this->getConn() != NULL) {
-    this->getConn()->trigger(event);
+  this->sendPending(pending);
+}
+
+
+
+/* Trigger an event and get its result as a future */
+TriggerFuture WebsocketRails::triggerAsync(std::string event_name, jsonxx::Object event_data) {
+  return this->triggerAsync(event_name, event_data, 0);
+}
+
+
+TriggerFuture WebsocketRails::triggerAsync(std::string event_name, jsonxx::Object event_data, long timeout) {
+  boost::shared_ptr<std::promise<jsonxx::Object> > promise = boost::make_shared<std::promise<jsonxx::Object> >();
+  std::future<jsonxx::Object> future = promise->get_future();
+  jsonxx::Array data;
+  data << event_name << event_data << (this->getConn() != NULL ? this->getConn()->getConnectionId() : "");
+  Event event(data);
+  this->triggerWindowed(event, boost::bind(&TriggerFuture::resolve, promise, _1), boost::bind(&TriggerFuture::reject, promise, _1), timeout);
+  return TriggerFuture(*this, event.getId(), std::move(future));
+}
+
+
+#if __cplusplus >= 202002L
+/* Trigger an event from a coroutine: jsonxx::Object result = co_await dispatcher.triggerAwait(...) */
+TriggerAwaitable WebsocketRails::triggerAwait(std::string event_name, jsonxx::Object event_data) {
+  return TriggerAwaitable(*this, event_name, event_data, 0);
+}
+
+
+TriggerAwaitable WebsocketRails::triggerAwait(std::string event_name, jsonxx::Object event_data, long timeout) {
+  return TriggerAwaitable(*this, event_name, event_data, timeout);
+}
+#endif
+
+
+/* Give up on the result of an event, its failure callback gets {"error": "cancelled"} */
+bool WebsocketRails::cancel(std::string event_id) {
+  EventId id;
+  if(!EventId::parse(event_id.data(), event_id.size(), id)) {
+    return false;
   }
+  return this->failEvent(id, "cancelled");
+}
+
+
+/* Limit the correlated events in flight, 0 for no limit */
+void WebsocketRails::setInFlightWindow(std::size_t limit, WindowPolicy policy) {
+  this->window.setLimit(limit);
+  this->window.setPolicy(policy);
+}
+
+
+/* Limit the correlated events in flight of one event name, 0 for no limit */
+void WebsocketRails::setInFlightWindow(std::string event_name, std::size_t limit) {
+  this->window.setLimit(event_name, limit);
+}
+
+
+/* Longest wait in milliseconds of a trigger blocked on a full window */
+void WebsocketRails::setWindowBlockTimeout(long timeout) {
+  this->window.setBlockTimeout(timeout);
+}
+
+
+WindowStats WebsocketRails::getWindowStats() {
+  return this->window.getStats();
+}
+
+
+std::size_t WebsocketRails::getInFlight(std::string event_name) {
+  return this->window.getInFlight(event_name);
 }
 
 
@@ -213,63 +739,55 @@ void WebsocketRails::triggerEvent(Event event) {
  ************************************/
 
 
+/* The subscribed channel, NULL if there is none */
 Channel * WebsocketRails::getChannel(std::string channel_name) {
-  return &this->channel_queue[channel_name];
+  boost::shared_ptr<const map_channel> channels = this->loadChannels();
+  map_channel::const_iterator found = channels->find(channel_name);
+  return found != channels->end() ? found->second.get() : NULL;
 }
 
 
 Channel * WebsocketRails::subscribe(std::string channel_name) {
-  if(this->channel_queue.find(channel_name) == this->channel_queue.end()) {
-    Channel channel(channel_name, *this, false);
-    this->channel_queue[channel_name] = channel;
-  }
-  return &this->channel_queue[channel_name];
+  return this->processSubscribe(channel_name, false, cb_func(), cb_func());
 }
 
 
 Channel * WebsocketRails::subscribe(std::string channel_name, cb_func success_callback, cb_func failure_callback) {
-  if(this->channel_queue.find(channel_name) == this->channel_queue.end()) {
-    Channel channel(channel_name, *this, false, success_callback, failure_callback);
-    this->channel_queue[channel_name] = channel;
-  }
-  return &this->channel_queue[channel_name];
+  return this->processSubscribe(channel_name, false, std::move(success_callback), std::move(failure_callback));
 }
 
 
 Channel * WebsocketRails::subscribePrivate(std::string channel_name) {
-  if(this->channel_queue.find(channel_name) == this->channel_queue.end()) {
-    Channel channel(channel_name, *this, true);
-    this->channel_queue[channel_name] = channel;
-  }
-  return &this->channel_queue[channel_name];
+  return this->processSubscribe(channel_name, true, cb_func(), cb_func());
 }
 
 
 Channel * WebsocketRails::subscribePrivate(std::string channel_name, cb_func success_callback, cb_func failure_callback) {
-  if(this->channel_queue.find(channel_name) == this->channel_queue.end()) {
-    Channel channel(channel_name, *this, true, success_callback, failure_callback);
-    this->channel_queue[channel_name] = channel;
-  }
-  return &this->channel_queue[channel_name];
+  return this->processSubscribe(channel_name, true, std::move(success_callback), std::move(failure_callback));
 }
 
 
 void WebsocketRails::unsubscribe(std::string channel_name) {
-  if(this->channel_queue.find(channel_name) == this->channel_queue.end()) {
-    return;
-  }
-  cb_func success_callback, failure_callback;
-  this->channel_queue[channel_name].destroy(success_callback, failure_callback);
-  this->channel_queue.erase(channel_name);
+  this->unsubscribe(channel_name, cb_func(), cb_func());
 }
 
 
+/* The channel leaves the table at once, dispatches already holding it finish on the old snapshot */
 void WebsocketRails::unsubscribe(std::string channel_name, cb_func success_callback, cb_func failure_callback) {
-  if(this->channel_queue.find(channel_name) == this->channel_queue.end()) {
-    return;
+  boost::shared_ptr<Channel> channel;
+  {
+    boost::lock_guard<boost::mutex> guard(this->channel_mutex);
+    map_channel::const_iterator found = this->channel_queue->find(channel_name);
+    if(found == this->channel_queue->end()) {
+      return;
+    }
+    channel = found->second;
+    boost::shared_ptr<map_channel> channels = boost::make_shared<map_channel>(*this->channel_queue);
+    channels->erase(channel_name);
+    boost::shared_ptr<const map_channel> published = channels;
+    boost::atomic_store(&this->channel_queue, published);
   }
-  this->channel_queue[channel_name].destroy(success_callback, failure_callback);
-  this->channel_queue.erase(channel_name);
+  channel->destroy(std::move(success_callback), std::move(failure_callback));
 }
 
 
@@ -281,14 +799,72 @@ void WebsocketRails::unsubscribe(std::string channel_name, cb_func success_callb
  ********************************************************/
 
 
+/* Published with release, the winner of a connect race is set on its own IO thread */
 void WebsocketRails::setConn(WebsocketConnection * conn) {
-  this->conn = conn;
+  this->conn.store(conn, boost::memory_order_release);
+}
+
+
+/* Publish a new channel before its subscribe goes out, so its token can never arrive first */
+Channel * WebsocketRails::processSubscribe(std::string channel_name, bool is_private, cb_func success_callback, cb_func failure_callback) {
+  boost::shared_ptr<Channel> channel;
+  {
+    boost::lock_guard<boost::mutex> guard(this->channel_mutex);
+    map_channel::const_iterator found = this->channel_queue->find(channel_name);
+    if(found != this->channel_queue->end()) {
+      return found->second.get();
+    }
+    channel = boost::make_shared<Channel>();
+    channel->name = channel_name;
+    channel->is_private = is_private;
+    channel->on_success = std::move(success_callback);
+    channel->on_failure = std::move(failure_callback);
+    channel->dispatcher = this;
+    boost::shared_ptr<map_channel> channels = boost::make_shared<map_channel>(*this->channel_queue);
+    (*channels)[channel_name] = channel;
+    boost::shared_ptr<const map_channel> published = channels;
+    boost::atomic_store(&this->channel_queue, published);
+  }
+  channel->initObject();
+  return channel.get();
+}
+
+
+/* The current channel table, it stays valid for as long as it is held */
+boost::shared_ptr<const map_channel> WebsocketRails::loadChannels() {
+  return boost::atomic_load(&this->channel_queue);
+}
+
+
+/* Close the connection if it is open and delete it once its handlers are done */
+void WebsocketRails::closeConnection(bool open) {
+  if(this->getConn() == NULL) {
+    return;
+  }
+  LivenessStats liveness = this->getConn()->getLivenessStats();
+  if(liveness.pongs > 0) {
+    this->endpoints.measured(this->getConn()->getUrl(), liveness.rtt_avg);
+  }
+  if(open) {
+    this->getConn()->close();
+  }
+  if(this->io_service != NULL) {
+    /* Let the handlers of the connection finish before it is deleted */
+    this->waitFor(boost::bind(&WebsocketConnection::isIdle, this->getConn()), TIMEOUT_CONN);
+    this->poll();
+  }
+  this->websocket_connection_thread.interrupt();
+  this->websocket_connection_thread.join();
+  delete this->getConn();
+  this->setConn(NULL);
 }
 
 
 void WebsocketRails::connectionEstablished(jsonxx::Object event_data) {
-  this->state = "connected";
   this->getConn()->setConnectionId(event_data.get<jsonxx::String>("connection_id"));
+  if(!this->state.transition(STATE_CONNECTING, STATE_CONNECTED)) {
+    return;
+  }
   this->getConn()->flushQueue();
   if(this->on_open_callback) {
     this->on_open_callback(event_data);
@@ -296,49 +872,319 @@ void WebsocketRails::connectionEstablished(jsonxx::Object event_data) {
 }
 
 
-void WebsocketRails::dispatch(Event event) {
-  if(this->callbacks.find(event.getName()) == this->callbacks.end()) {
+void WebsocketRails::dispatch(FrameEvent & event) {
+  std::string event_name = event.getName().str();
+  /* The snapshot keeps its callbacks alive even if they are unbound while running */
+  boost::shared_ptr<const CallbackSnapshot> snapshot = this->callbacks.load();
+  vec_cb_func matched;
+  const vec_cb_func * event_callbacks = snapshot->select(event_name, snapshot->isFiltered(event_name) ? event.getRawData() : StringRef(), matched);
+  if(event_callbacks == NULL) {
+    return;
+  }
+  jsonxx::Object event_data = event.getData();
+  if(this->profiler) {
+    this->profiler->dispatch("events", event_name, *event_callbacks, event_data);
     return;
   }
-  vec_cb_func event_callbacks = this->callbacks[event.getName()];
-  for(vec_cb_func::iterator it = event_callbacks.begin(); it != event_callbacks.end(); ++it) {
-    cb_func callback = *it;
-    callback(event.getData());
+  for(vec_cb_func::const_iterator it = event_callbacks->begin(); it != event_callbacks->end(); ++it) {
+    (**it)(event_data);
   }
 }
 
 
-void WebsocketRails::dispatchChannel(Event event) {
-  if(this->channel_queue.find(event.getChannel()) == this->channel_queue.end()) {
+void WebsocketRails::dispatchChannel(FrameEvent & event) {
+  boost::shared_ptr<const map_channel> channels = this->loadChannels();
+  map_channel::const_iterator found = channels->find(event.getChannel().str());
+  if(found == channels->end()) {
     return;
   }
-  this->channel_queue[event.getChannel()].dispatch(event.getName(), event.getData());
+  std::string event_name = event.getName().str();
+  Channel & channel = *found->second;
+  boost::shared_ptr<const CallbackSnapshot> snapshot = channel.getCallbackTable()->load();
+  vec_cb_func matched;
+  const vec_cb_func * event_callbacks = snapshot->select(event_name, snapshot->isFiltered(event_name) ? event.getRawData() : StringRef(), matched);
+  if(event_callbacks == NULL) {
+    if(!channel.keepsData(event_name)) {
+      return;
+    }
+    event_callbacks = &matched;
+  }
+  channel.dispatch(event_name, event.getData(), *event_callbacks);
 }
 
 
 void WebsocketRails::pong() {
-  jsonxx::Array data;
-  data << "websocket_rails.pong" << jsonxx::Object() << (this->getConn() != NULL ? this->getConn()->getConnectionId() : "");
-  Event pong(data);
-  this->getConn()->trigger(pong);
+  this->getConn()->pong();
 }
 
 
+/* Not connected, or the heartbeat monitor gave the connection up and its close handler has yet to run */
 bool WebsocketRails::connectionStale() {
-  return this->state != "connected";
+  return !this->state.is(STATE_CONNECTED) || (this->getConn() != NULL && !this->getConn()->isAlive());
 }
 
 
 void WebsocketRails::reconnectChannels() {
-  std::tr1::unordered_map<std::string, Channel> channel_queue_old = this->channel_queue;
-  for(auto& x: channel_queue_old) {
-    Channel * channel = &x.second;
+  boost::shared_ptr<const map_channel> channel_queue_old = this->loadChannels();
+  for(auto& x: *channel_queue_old) {
+    Channel * channel = x.second.get();
     map_vec_cb_func callbacks = channel->getCallbacks();
-    cb_func success_callback, failure_callback;
-    channel->destroy(success_callback, failure_callback);
+    map_vec_filtered_cb filtered_callbacks = channel->getFilteredCallbacks();
+    boost::shared_ptr<Conflator> conflator = channel->getConflator();
     std::string channel_name = channel->getName();
-    this->channel_queue.erase(channel_name);
+    this->unsubscribe(channel_name);
     channel = channel->isPrivate() ? this->subscribePrivate(channel_name) : this->subscribe(channel_name);
     channel->setCallbacks(callbacks);
+    channel->setFilteredCallbacks(filtered_callbacks);
+    channel->setConflator(conflator);
+  }
+}
+
+
+/* Fail the events whose results did not arrive in time */
+void WebsocketRails::expireEvents() {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::vector<PendingEvent> expired;
+  {
+    boost::lock_guard<boost::mutex> guard(this->event_queue_mutex);
+    std::multimap<std::chrono::steady_clock::time_point, EventId>::iterator end = this->event_deadlines.upper_bound(now);
+    for(std::multimap<std::chrono::steady_clock::time_point, EventId>::iterator it = this->event_deadlines.begin(); it != end; ++it) {
+      std::tr1::unordered_map<EventId, PendingEvent, EventIdHash>::iterator found = this->event_queue.find(it->second);
+      if(found != this->event_queue.end() && found->second.getDeadline() == it->first) {
+        expired.push_back(found->second);
+        this->event_queue.erase(found);
+      }
+    }
+    this->event_deadlines.erase(this->event_deadlines.begin(), end);
+  }
+  for(std::vector<PendingEvent>::iterator it = expired.begin(); it != expired.end(); ++it) {
+    this->releaseWindow(*it);
+    it->runCallbacks(false, jsonxx::Object("error", "timeout"));
+  }
+  expired = this->window.takeExpired(now);
+  for(std::vector<PendingEvent>::iterator it = expired.begin(); it != expired.end(); ++it) {
+    it->runCallbacks(false, jsonxx::Object("error", "timeout"));
+  }
+  this->armDeadlines();
+}
+
+
+/* Arm the deadline timer for the earliest deadline left, sent or queued */
+void WebsocketRails::armDeadlines() {
+  std::chrono::steady_clock::time_point next = this->window.nextDeadline();
+  {
+    boost::lock_guard<boost::mutex> guard(this->event_queue_mutex);
+    if(!this->event_deadlines.empty() && (next == std::chrono::steady_clock::time_point() || this->event_deadlines.begin()->first < next)) {
+      next = this->event_deadlines.begin()->first;
+    }
+  }
+  if(next != std::chrono::steady_clock::time_point()) {
+    this->deadlines.arm(next);
+  }
+}
+
+
+bool WebsocketRails::failEvent(EventId id, std::string reason) {
+  PendingEvent pending;
+  if(this->window.withdraw(id, pending)) {
+    pending.runCallbacks(false, jsonxx::Object("error", reason));
+    return true;
+  }
+  boost::unique_lock<boost::mutex> lock(this->event_queue_mutex);
+  std::tr1::unordered_map<EventId, PendingEvent, EventIdHash>::iterator found = this->event_queue.find(id);
+  if(found == this->event_queue.end()) {
+    return false;
+  }
+  pending = found->second;
+  this->event_queue.erase(found);
+  lock.unlock();
+  this->releaseWindow(pending);
+  pending.runCallbacks(false, jsonxx::Object("error", reason));
+  return true;
+}
+
+
+/* Wait until done() holds, driving the caller's loop unless a reactor or a thread of its own runs it */
+bool WebsocketRails::waitFor(boost::function<bool()> done, long seconds) {
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+  while(!done() && std::chrono::steady_clock::now() < deadline) {
+    if(this->io_service == NULL || this->reactor != NULL) {
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    } else {
+      this->runFor(10);
+    }
+  }
+  return done();
+}
+
+
+bool WebsocketRails::pendingDone() {
+  boost::lock_guard<boost::mutex> guard(this->event_queue_mutex);
+  return this->event_queue.empty() || !this->isConnected();
+}
+
+
+/* Happy eyeballs over the endpoints, best ranked first: each one starts race_stagger ms after the one before, or at
+   once when all running ones failed. The first to deliver client_connected becomes the connection, the rest are dropped */
+bool WebsocketRails::race() {
+  this->reapAttempts(false);
+  std::vector<std::string> urls = this->endpoints.ranked();
+  std::vector<ConnectAttempt> attempts;
+  {
+    boost::lock_guard<boost::mutex> guard(this->race_mutex);
+    this->race_winner = NULL;
+  }
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point deadline = now + std::chrono::seconds(TIMEOUT_CONN);
+  std::chrono::steady_clock::time_point next_start = now;
+  WebsocketConnection * winner = NULL;
+  while(winner == NULL) {
+    now = std::chrono::steady_clock::now();
+    bool running = false;
+    for(std::vector<ConnectAttempt>::iterator it = attempts.begin(); it != attempts.end(); ++it) {
+      running = running || !it->conn->isClosed();
+    }
+    if(now >= deadline || (!running && attempts.size() == urls.size())) {
+      break;
+    }
+    if(attempts.size() < urls.size() && (!running || now >= next_start)) {
+      attempts.push_back(this->startAttempt(urls[attempts.size()]));
+      next_start = now + std::chrono::milliseconds(this->race_stagger);
+      continue;
+    }
+    if(this->io_service == NULL || this->reactor != NULL) {
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    } else {
+      this->runFor(10);
+    }
+    boost::lock_guard<boost::mutex> guard(this->race_mutex);
+    winner = this->race_winner;
+  }
+  {
+    /* A candidate may have won after the last look, none can once the candidates are gone */
+    boost::lock_guard<boost::mutex> guard(this->race_mutex);
+    winner = this->race_winner;
+    this->candidates.clear();
+  }
+  for(std::vector<ConnectAttempt>::iterator it = attempts.begin(); it != attempts.end(); ++it) {
+    if(it->conn == winner) {
+      this->endpoints.connected(it->url, std::chrono::duration_cast<std::chrono::microseconds>(now - it->started).count());
+      /* candidateMessage made it the connection already */
+      if(it->thread) {
+        this->websocket_connection_thread.swap(*it->thread);
+      }
+      continue;
+    }
+    /* Slower than the winner is no failure, failing or timing out is */
+    if(winner == NULL || it->conn->isClosed()) {
+      this->endpoints.failed(it->url);
+    }
+    this->retireAttempt(*it);
+  }
+  return winner != NULL;
+}
+
+
+ConnectAttempt WebsocketRails::startAttempt(std::string url) {
+  ConnectAttempt attempt(url, new WebsocketConnection(url, *this));
+  {
+    boost::lock_guard<boost::mutex> guard(this->race_mutex);
+    this->candidates.push_back(attempt.conn);
+  }
+  if(this->io_service != NULL) {
+    attempt.conn->start();
+  } else {
+    attempt.thread = boost::make_shared<boost::thread>(&WebsocketConnection::run, attempt.conn);
+  }
+  return attempt;
+}
+
+
+/* Drop a race loser. One with a loop of its own is deleted right away, one on a shared loop once it is idle */
+void WebsocketRails::retireAttempt(ConnectAttempt & attempt) {
+  attempt.conn->abort();
+  if(attempt.thread) {
+    attempt.thread->join();
+    delete attempt.conn;
+    return;
+  }
+  this->retired.push_back(attempt);
+}
+
+
+/* Delete the race losers whose handlers are done, waiting for them if asked to */
+void WebsocketRails::reapAttempts(bool wait) {
+  std::vector<ConnectAttempt> busy;
+  for(std::vector<ConnectAttempt>::iterator it = this->retired.begin(); it != this->retired.end(); ++it) {
+    if(wait) {
+      this->waitFor(boost::bind(&WebsocketConnection::isIdle, it->conn), TIMEOUT_CONN);
+    }
+    if(it->conn->isIdle()) {
+      this->poll();
+      delete it->conn;
+    } else {
+      busy.push_back(*it);
+    }
+  }
+  this->retired.swap(busy);
+}
+
+
+/* Trigger a correlated event through the in-flight window */
+void WebsocketRails::triggerWindowed(Event event, cb_func success_callback, cb_func failure_callback, long timeout) {
+  PendingEvent pending(event, std::move(success_callback), std::move(failure_callback));
+  pending.setWindowed(true);
+  if(timeout > 0) {
+    pending.setDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout));
+  }
+  /* Blocking on the asio thread would stop the results that free the slots */
+  bool may_block = this->getConn() == NULL || !this->getConn()->isIoThread();
+  switch(this->window.acquire(pending, may_block)) {
+    case WINDOW_ACQUIRED:
+      this->sendPending(pending);
+      break;
+    case WINDOW_REJECTED:
+    case WINDOW_FULL:
+      pending.runCallbacks(false, jsonxx::Object("error", "window_full"));
+      break;
+    case WINDOW_DEFERRED:
+      if(pending.getDeadline() != std::chrono::steady_clock::time_point()) {
+        this->deadlines.arm(pending.getDeadline());
+      }
+      break;
+  }
+}
+
+
+/* Register the event for its result and send it */
+void WebsocketRails::sendPending(PendingEvent pending) {
+  Event event = pending.getEvent();
+  {
+    boost::lock_guard<boost::mutex> guard(this->event_queue_mutex);
+    if(this->event_queue.find(event.getEventId()) == this->event_queue.end()) {
+      if(pending.getDeadline() != std::chrono::steady_clock::time_point()) {
+        this->event_deadlines.insert(std::make_pair(pending.getDeadline(), event.getEventId()));
+      }
+      this->event_queue[event.getEventId()] = pending;
+    }
+  }
+  /* After the insert, so a timer firing meanwhile arms itself for it */
+  if(pending.getDeadline() != std::chrono::steady_clock::time_point()) {
+    this->deadlines.arm(pending.getDeadline());
+  }
+  if(this->getConn() != NULL) {
+    this->getConn()->trigger(event);
+  }
+}
+
+
+/* Give the slot of a finished event back and send the events it admits */
+void WebsocketRails::releaseWindow(PendingEvent & pending) {
+  if(!pending.isWindowed()) {
+    return;
+  }
+  std::vector<PendingEvent> admitted = this->window.release(pending.getEvent().getName());
+  for(std::vector<PendingEvent>::iterator it = admitted.begin(); it != admitted.end(); ++it) {
+    this->sendPending(*it);
   }
 }
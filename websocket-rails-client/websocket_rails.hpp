@@ -29,6 +29,38 @@
 #include "event.hpp"
 #include "channel.hpp"
 #include "websocket_connection.hpp"
+#include "frame_event.hpp"
+#include "trigger_future.hpp"
+#include "in_flight_window.hpp"
+#include "reactor.hpp"
+#include "connection_state.hpp"
+#include "dedup_window.hpp"
+#include "callback_profiler.hpp"
+#include "delivery_executor.hpp"
+#include "deadline_timer.hpp"
+#include "endpoint_set.hpp"
+
+/**
+ *  A connection started in a connect race.
+ **/
+struct ConnectAttempt {
+  ConnectAttempt(std::string url, WebsocketConnection * conn) : url(url), conn(conn), started(std::chrono::steady_clock::now()) {}
+  std::string url;
+  WebsocketConnection * conn;
+  boost::shared_ptr<boost::thread> thread;          /* Runs the connection unless the dispatcher has a loop */
+  std::chrono::steady_clock::time_point started;
+};
+
+/**
+ *  A session taken for a handover: its snapshot and the events taken out
+ *  of the queues, kept until the handover is committed or rolled back.
+ **/
+struct SessionExport {
+  std::string snapshot;
+  std::vector<std::pair<std::string, std::queue<Event> > > channel_queues;   /* Channel Name, Events waiting for its token */
+  std::queue<Event> connection_queue;                                       /* Events waiting for the connection         */
+  std::vector<PendingEvent> waiting;                                        /* Events waiting for a window slot          */
+};
 
 class WebsocketRails {
 public:
@@ -38,6 +70,8 @@ public:
    **/
   WebsocketRails();
   WebsocketRails(std::string url);
+  WebsocketRails(std::string url, boost::asio::io_service & io_service);
+  WebsocketRails(std::string url, Reactor & reactor);
 
   /**
    *  Connection functions
@@ -45,30 +79,91 @@ public:
   std::string connect();
   std::string disconnect();
   void reconnect();
+  std::string exportSession();
+  SessionExport takeSession();
+  void commitSession(SessionExport & session);
+  void restoreSession(SessionExport & session);
+  bool importSession(std::string snapshot);
+  bool importChannels(std::string snapshot);
+  bool importEvents(std::string snapshot);
+  bool drain(long seconds);
+  std::size_t poll();
+  std::size_t runFor(long milliseconds);
+  boost::asio::io_service * getIoService();
+  Reactor * getReactor();
   std::string getState();
-  std::string setState(std::string state);
+  ConnectionState getConnectionState();
+  bool setState(ConnectionState state);
+  bool setState(ConnectionState from, ConnectionState to);
+  void onStateChange(state_cb_func callback);
   WebsocketConnection * getConn();
   bool isConnected();
+  HeartbeatStats getHeartbeatStats();
+  void setFrameArenaSize(std::size_t block_size);
+  std::size_t getFrameArenaSize();
+  void setLaneShares(unsigned int control_share, unsigned int bulk_share);
+  unsigned int getControlShare();
+  unsigned int getBulkShare();
+  LaneStats getLaneStats();
+  MessagePoolStats getMessagePoolStats();
+  void setLatencyProfile(LatencyProfile profile);
+  LatencyProfile getLatencyProfile();
+  void setHeartbeatPolicy(HeartbeatPolicy policy);
+  HeartbeatPolicy getHeartbeatPolicy();
+  LivenessStats getLivenessStats();
+  void setWireFormat(WireFormat format);
+  WireFormat getWireFormat();
+  void setDedupWindow(std::size_t capacity, long max_age);
+  DedupStats getDedupStats();
+  void setProfiling(bool enabled);
+  CallbackProfiler * getProfiler();
+  boost::shared_ptr<CallbackProfiler> shareProfiler();
+  boost::shared_ptr<DeliveryExecutor> getDeliveryExecutor();
+  void addEndpoint(std::string url);
+  std::string getEndpoint();
+  vec_endpoint_stats getEndpointStats();
+  void setRaceStagger(long milliseconds);
+  long getRaceStagger();
 
   /**
    *  Connection callbacks
    **/
-  void newMessage(jsonxx::Array data);
+  void newMessage(vec_frame_event & data);
+  void candidateMessage(WebsocketConnection * conn, vec_frame_event & data);
+  void endpointFailed(std::string url);
   void onOpen(cb_func callback);
   void onClose(cb_func callback);
   void onFail(cb_func callback);
-  cb_func getOnCloseCallback();
-  cb_func getOnFailCallback();
+  const cb_func & getOnCloseCallback();
+  const cb_func & getOnFailCallback();
 
 
   /**
    *  Event functions
    **/
   void bind(std::string event_name, cb_func callback);
+  void bind(std::string event_name, cb_func callback, std::string label);
+  void bind(std::string event_name, EventFilter filter, cb_func callback);
+  void bind(std::string event_name, EventFilter filter, cb_func callback, std::string label);
   void unbindAll(std::string event_name);
   void trigger(std::string event_name, jsonxx::Object event_data);
   void trigger(std::string event_name, jsonxx::Object event_data, cb_func success_callback, cb_func failure_callback);
   void triggerEvent(Event event);
+  void trigger(std::string event_name, jsonxx::Object event_data, cb_func success_callback, cb_func failure_callback, long timeout);
+  void triggerEvent(Event event, cb_func success_callback, cb_func failure_callback);
+  void triggerEvent(Event event, cb_func success_callback, cb_func failure_callback, long timeout);
+  TriggerFuture triggerAsync(std::string event_name, jsonxx::Object event_data);
+  TriggerFuture triggerAsync(std::string event_name, jsonxx::Object event_data, long timeout);
+#if __cplusplus >= 202002L
+  TriggerAwaitable triggerAwait(std::string event_name, jsonxx::Object event_data);
+  TriggerAwaitable triggerAwait(std::string event_name, jsonxx::Object event_data, long timeout);
+#endif
+  bool cancel(std::string event_id);
+  void setInFlightWindow(std::size_t limit, WindowPolicy policy);
+  void setInFlightWindow(std::string event_name, std::size_t limit);
+  void setWindowBlockTimeout(long timeout);
+  WindowStats getWindowStats();
+  std::size_t getInFlight(std::string event_name);
 
   /**
    *  Channel functions
@@ -82,32 +177,72 @@ public:
   void unsubscribe(std::string channel_name, cb_func success_callback, cb_func failure_callback);
 
 private:
+#if __cplusplus >= 202002L
+  friend class TriggerAwaitable;
+#endif
 
   /**
    *  Variables
    **/
   std::string url;
-  std::string state;
+  ConnectionStateMachine state;
+  std::size_t frame_arena_size;
+  boost::asio::io_service * io_service;                             /* Caller-owned loop, NULL to run on a thread of its own */
+  Reactor * reactor;                                                /* Shared thread pool running io_service, or NULL */
+  unsigned int control_share;
+  unsigned int bulk_share;
+  LatencyProfile latency_profile;
+  HeartbeatPolicy heartbeat_policy;
+  WireFormat wire_format;
+  EndpointSet endpoints;
+  long race_stagger;                                                /* Milliseconds between the starts of a connect race */
+  boost::mutex race_mutex;
+  std::vector<WebsocketConnection *> candidates;                    /* Connections of the running race */
+  WebsocketConnection * race_winner;                                /* First candidate with client_connected, or NULL */
+  jsonxx::Object race_data;                                         /* Its client_connected data */
+  std::vector<ConnectAttempt> retired;                              /* Race losers on a shared loop, deleted once idle */
+  boost::shared_ptr<DedupWindow> dedup;                             /* NULL unless de-duplication is on */
+  boost::shared_ptr<CallbackProfiler> profiler;                     /* NULL unless profiling is on */
+  boost::shared_ptr<DeliveryExecutor> delivery;                     /* Delivery thread of the conflated channels, NULL until the first */
   boost::thread websocket_connection_thread;
   cb_func on_open_callback;
   cb_func on_close_callback;
   cb_func on_fail_callback;
-  map_vec_cb_func callbacks;                                        /* Map<key,value>: Event Name, Callback Array     */
-  std::tr1::unordered_map<std::string, Channel> channel_queue;      /* Map<key,value>: Channel Name, Channel Object   */
-  std::tr1::unordered_map<std::string, Event> event_queue;          /* Map<key,value>: Event UUID, Event Object       */
-  WebsocketConnection * conn;
+  CallbackTable callbacks;                                          /* Event Name, Callbacks: copy-on-write snapshots */
+  boost::shared_ptr<const map_channel> channel_queue;               /* Map<key,value>: Channel Name, Channel Object, swapped on change */
+  boost::mutex channel_mutex;                                       /* Serializes subscribe and unsubscribe */
+  std::tr1::unordered_map<EventId, PendingEvent, EventIdHash> event_queue; /* Map<key,value>: Event UUID, Pending Event */
+  std::multimap<std::chrono::steady_clock::time_point, EventId> event_deadlines;
+  boost::mutex event_queue_mutex;
+  InFlightWindow window;
+  boost::atomic<WebsocketConnection *> conn;                        /* Read by app threads without a lock */
+  DeadlineTimer deadlines;                                          /* Runs expireEvents, last so it stops first */
 
   /**
    *  Functions
    **/
-  Channel * processSubscribe(std::string channel_name, bool is_private);
+  Channel * processSubscribe(std::string channel_name, bool is_private, cb_func success_callback, cb_func failure_callback);
+  boost::shared_ptr<const map_channel> loadChannels();
   void setConn(WebsocketConnection * conn);
+  void closeConnection(bool open);
   void connectionEstablished(jsonxx::Object data);
-  void dispatch(Event event);
-  void dispatchChannel(Event event);
+  void dispatch(FrameEvent & event);
+  void dispatchChannel(FrameEvent & event);
   void pong();
   bool connectionStale();
   void reconnectChannels();
+  void expireEvents();
+  void armDeadlines();
+  bool failEvent(EventId id, std::string reason);
+  void triggerWindowed(Event event, cb_func success_callback, cb_func failure_callback, long timeout);
+  void sendPending(PendingEvent pending);
+  void releaseWindow(PendingEvent & pending);
+  bool waitFor(boost::function<bool()> done, long seconds);
+  bool pendingDone();
+  bool race();
+  ConnectAttempt startAttempt(std::string url);
+  void retireAttempt(ConnectAttempt & attempt);
+  void reapAttempts(bool wait);
 
 };
 
@@ -0,0 +1,58 @@
+/**
+ *
+ * Name        : wire_codec.cpp
+ * Version     : v0.7.4
+ * Description : WireCodec Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "wire_codec.hpp"
+#include "json_codec.hpp"
+#include "msgpack_codec.hpp"
+
+
+
+/************************************
+ *  Constructors                    *
+ ************************************/
+
+WireCodec::~WireCodec() {}
+
+
+
+/************************************
+ *  Functions                       *
+ ************************************/
+
+boost::shared_ptr<WireCodec> WireCodec::create(WireFormat format) {
+  if(format == WIRE_MSGPACK) {
+    return boost::make_shared<MsgpackCodec>();
+  }
+  return boost::make_shared<JsonCodec>();
+}
+
+
+/* The codec of a negotiated subprotocol, JSON if none or an unknown one was agreed on */
+boost::shared_ptr<WireCodec> WireCodec::create(std::string subprotocol) {
+  if(subprotocol == MsgpackCodec::subprotocol) {
+    return boost::make_shared<MsgpackCodec>();
+  }
+  return boost::make_shared<JsonCodec>();
+}
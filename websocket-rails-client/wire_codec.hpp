@@ -0,0 +1,67 @@
+/**
+ *
+ * Name        : wire_codec.hpp
+ * Version     : v0.7.4
+ * Description : WireCodec Header Class in C++, Ansi-style
+ * Author      : Egon Zemmer
+ * Company     : Phlegx Systems
+ * License     : The MIT License (http://opensource.org/licenses/MIT)
+ *
+ * Copyright (C) 2015 Egon Zemmer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#ifndef WIRE_CODEC_HPP_
+#define WIRE_CODEC_HPP_
+
+#include "websocket.hpp"
+#include "event.hpp"
+#include "frame_arena.hpp"
+#include "frame_event.hpp"
+
+enum WireFormat {
+  WIRE_JSON,        /* Websocket-Rails JSON text frames, no subprotocol                */
+  WIRE_MSGPACK      /* MessagePack binary frames, subprotocol websocket_rails.msgpack  */
+};
+
+/**
+ *  Encoding of events on the wire. A codec instance belongs to one
+ *  connection and is only used on its IO thread for decoding.
+ **/
+class WireCodec {
+public:
+
+  /**
+   *  Constructors
+   **/
+  virtual ~WireCodec();
+
+  /**
+   *  Functions
+   **/
+  virtual WireFormat getFormat() = 0;
+  virtual std::string getSubprotocol() = 0;
+  virtual websocketpp::frame::opcode::value getOpcode() = 0;
+  virtual std::string encode(Event event) = 0;
+  virtual bool decode(const std::string & payload, FrameArena & arena, vec_frame_event & events) = 0;
+  virtual bool isPing(const std::string & payload) = 0;
+  virtual const std::string & getPongFrame() = 0;
+  static boost::shared_ptr<WireCodec> create(WireFormat format);
+  static boost::shared_ptr<WireCodec> create(std::string subprotocol);
+
+};
+
+
+#endif /* WIRE_CODEC_HPP_ */